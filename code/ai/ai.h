@@ -557,6 +557,11 @@ void ai_object_init(object * obj, int ai_index);
 // Called once a frame
 void ai_process( object * obj, int ai_index, float frametime );
 
+// Called once a frame before any object is moved. With -parallel_ai this searches for the targets of all ships
+// which are going to look for a new enemy this frame on the worker threads. ai_process then uses these results
+// instead of doing the search itself, as long as the found target is still valid.
+void ai_frame_prepare();
+
 int get_wingnum(int objnum);
 
 void set_wingnum(int objnum, int wingnum);
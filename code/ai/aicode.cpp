@@ -24,6 +24,7 @@
 #include "ai/aiinternal.h"
 #include "asteroid/asteroid.h"
 #include "autopilot/autopilot.h"
+#include "cmdline/cmdline.h"
 #include "cmeasure/cmeasure.h"
 #include "debris/debris.h"
 #include "debugconsole/console.h"
@@ -54,6 +55,7 @@
 #include "object/object.h"
 #include "object/objectdock.h"
 #include "object/objectshield.h"
+#include "object/objectspatial.h"
 #include "object/waypoint.h"
 #include "parse/parselo.h"
 #include "physics/physics.h"
@@ -68,7 +70,9 @@
 #include "ship/shipfx.h"
 #include "ship/shiphit.h"
 #include "ship/subsysdamage.h"
+#include "tracing/tracing.h"
 #include "utils/Random.h"
+#include "utils/ThreadPool.h"
 #include "weapon/beam.h"
 #include "weapon/flak.h"
 #include "weapon/swarm.h"
@@ -2130,6 +2134,73 @@ void evaluate_object_as_nearest_objnum(eval_nearest_objnum *eno)
 }
 
 
+// A nearest enemy search done ahead of time by ai_frame_prepare()
+typedef struct ai_target_prediction {
+	int	signature;				// signature of the searching object, 0 if there is no prediction
+	int	enemy_team_mask;
+	int	enemy_wing;
+	float	range;
+	int	max_attackers;
+	int	ship_info_index;
+
+	int	nearest_objnum;
+	int	nearest_signature;
+} ai_target_prediction;
+
+static ai_target_prediction Ai_target_predictions[MAX_OBJECTS];
+static SCP_vector<int> Ai_target_prediction_objnums;
+
+/**
+ * Use the prediction made by ai_frame_prepare() for this search if there is one.
+ *
+ * The prediction was made before any object moved this frame so the predicted target is checked again against the
+ * current state. Each prediction is only used once.
+ *
+ * @return true if *nearest_objnum was set from the prediction
+ */
+static bool ai_use_target_prediction(int objnum, int enemy_team_mask, int enemy_wing, float range, int max_attackers, int ship_info_index, int *nearest_objnum)
+{
+	ai_target_prediction *prediction = &Ai_target_predictions[objnum];
+
+	if (prediction->signature == 0 || prediction->signature != Objects[objnum].signature)
+		return false;
+
+	if ((prediction->enemy_team_mask != enemy_team_mask) || (prediction->enemy_wing != enemy_wing) || (prediction->range != range)
+		|| (prediction->max_attackers != max_attackers) || (prediction->ship_info_index != ship_info_index))
+		return false;
+
+	prediction->signature = 0;
+
+	if (prediction->nearest_objnum < 0) {
+		*nearest_objnum = -1;
+		return true;
+	}
+
+	object *target_objp = &Objects[prediction->nearest_objnum];
+	if ((target_objp->signature != prediction->nearest_signature) || (target_objp->type != OBJ_SHIP) || target_objp->flags[Object::Object_Flags::Should_be_dead])
+		return false;
+
+	// other ships may have picked the same target since the prediction was made
+	eval_nearest_objnum eno;
+	eno.enemy_team_mask = enemy_team_mask;
+	eno.enemy_ship_info_index = ship_info_index;
+	eno.enemy_wing = enemy_wing;
+	eno.max_attackers = max_attackers;
+	eno.objnum = objnum;
+	eno.range = range;
+	eno.nearest_dist = range;
+	eno.nearest_objnum = -1;
+	eno.check_danger_weapon_objnum = 0;
+	eno.trial_objp = target_objp;
+	evaluate_object_as_nearest_objnum(&eno);
+
+	if (eno.nearest_objnum < 0)
+		return false;
+
+	*nearest_objnum = eno.nearest_objnum;
+	return true;
+}
+
 /**
  * Given an object and an enemy team, return the index of the nearest enemy object.
  * Unless aip->targeted_subsys != NULL, don't allow to attack objects with OF_PROTECTED bit set.
@@ -2145,7 +2216,10 @@ int get_nearest_objnum(int objnum, int enemy_team_mask, int enemy_wing, float ra
 {
 	object	*danger_weapon_objp;
 	ai_info	*aip;
-	ship_obj	*so;
+
+	int predicted_objnum;
+	if (ai_use_target_prediction(objnum, enemy_team_mask, enemy_wing, range, max_attackers, ship_info_index, &predicted_objnum))
+		return predicted_objnum;
 
 	// initialize eno struct
 	eval_nearest_objnum eno;
@@ -2159,9 +2233,13 @@ int get_nearest_objnum(int objnum, int enemy_team_mask, int enemy_wing, float ra
 	eno.nearest_objnum = -1;
 	eno.check_danger_weapon_objnum = 0;
 
-	// go through the list of all ships and evaluate as potential targets
-	for ( so = GET_FIRST(&Ship_obj_list); so != END_OF_LIST(&Ship_obj_list); so = GET_NEXT(so) ) {
-		eno.trial_objp = &Objects[so->objnum];
+	// go through the ships which can be near enough to be picked and evaluate them as potential targets
+	// the distance of fighters and bombers is halved when evaluating, and big ships use the distance to their bounding box
+	static thread_local SCP_vector<int> candidates;
+	candidates.clear();
+	obj_spatial_query_ships(&Objects[objnum].pos, 2.0f * range, enemy_team_mask, candidates);
+	for (int candidate : candidates) {
+		eno.trial_objp = &Objects[candidate];
 		evaluate_object_as_nearest_objnum(&eno);
 	}
 
@@ -11649,6 +11727,7 @@ void process_subobjects(int objnum)
 	ship_info	*sip = &Ship_info[shipp->ship_info_index];
 
 	model_subsystem	*psub;
+	ai_turret_batch_begin(objnum);
 	for ( pss = GET_FIRST(&shipp->subsys_list); pss !=END_OF_LIST(&shipp->subsys_list); pss = GET_NEXT(pss) ) {
 		psub = pss->system_info;
 
@@ -11694,6 +11773,7 @@ void process_subobjects(int objnum)
 		// do solar/radar/gas/activator rotation here
 		ship_do_submodel_rotation(shipp, psub, pss);
 	}
+	ai_turret_batch_end();
 
 	if (!(Game_mode & GM_LAB)) {
 		//	Deal with a ship with blown out engines.
@@ -14297,6 +14377,96 @@ int ai_need_new_target(object *pl_objp, int target_objnum)
 	return 0;
 }
 
+/**
+ * Return true if ai_frame() is going to search for a new enemy for this ship this frame.
+ * This mirrors the checks in ai_frame() and find_enemy() but does not need to be exact, a wrong guess only costs time.
+ */
+static bool ai_will_search_for_enemy(object *objp)
+{
+	ship *shipp = &Ships[objp->instance];
+	ai_info *aip = &Ai_info[shipp->ai_index];
+	ship_info *sip = &Ship_info[shipp->ship_info_index];
+
+	if ((aip->mode == AIM_WARP_OUT) || (aip->mode == AIM_PLAY_DEAD))
+		return false;
+
+	if (aip->ai_flags[AI::AI_Flags::Awaiting_repair, AI::AI_Flags::Being_repaired])
+		return false;
+
+	if ((sip->class_type < 0) || !(Ship_types[sip->class_type].flags[Ship::Type_Info_Flags::AI_auto_attacks]))
+		return false;
+
+	if (((aip->mode != AIM_EVADE_WEAPON) && (aip->active_goal == AI_ACTIVE_GOAL_DYNAMIC)) || (aip->resume_goal_time != -1))
+		return false;
+
+	if (!timestamp_elapsed(aip->choose_enemy_timestamp))
+		return false;
+
+	return ai_need_new_target(objp, aip->target_objnum) != 0;
+}
+
+static void ai_predict_target(int objnum)
+{
+	object *objp = &Objects[objnum];
+	ai_info *aip = &Ai_info[Ships[objp->instance].ai_index];
+	ai_target_prediction *prediction = &Ai_target_predictions[objnum];
+
+	// same arguments as the search in ai_frame()
+	prediction->enemy_team_mask = iff_get_attackee_mask(obj_team(objp));
+	prediction->enemy_wing = aip->enemy_wing;
+	prediction->range = MAX_ENEMY_DISTANCE;
+	prediction->max_attackers = The_mission.ai_profile->max_attackers[Game_skill_level];
+	prediction->ship_info_index = -1;
+
+	// the signature is still 0 here so this does the actual search
+	int nearest_objnum = get_nearest_objnum(objnum, prediction->enemy_team_mask, prediction->enemy_wing, prediction->range, prediction->max_attackers, prediction->ship_info_index);
+
+	prediction->nearest_objnum = nearest_objnum;
+	prediction->nearest_signature = (nearest_objnum >= 0) ? Objects[nearest_objnum].signature : 0;
+	prediction->signature = objp->signature;
+}
+
+void ai_frame_prepare()
+{
+	for (auto objnum : Ai_target_prediction_objnums) {
+		Ai_target_predictions[objnum].signature = 0;
+	}
+	Ai_target_prediction_objnums.clear();
+
+	if (!Cmdline_parallel_ai || physics_paused || ai_paused || MULTIPLAYER_CLIENT)
+		return;
+
+	auto& pool = util::worker_pool();
+	if (pool.concurrency() <= 1)
+		return;
+
+	TRACE_SCOPE(tracing::AIPrepare);
+
+	// the searches query the spatial index from the worker threads so it has to be built here
+	obj_spatial_update();
+
+	for (ship_obj *so = GET_FIRST(&Ship_obj_list); so != END_OF_LIST(&Ship_obj_list); so = GET_NEXT(so)) {
+		object *objp = &Objects[so->objnum];
+		ship *shipp = &Ships[objp->instance];
+
+		if (objp->flags[Object::Object_Flags::Should_be_dead] || (shipp->ai_index < 0) || shipp->flags[Ship::Ship_Flags::Dying])
+			continue;
+
+		if ((objp->flags[Object::Object_Flags::Player_ship]) && !Player_use_ai)
+			continue;
+
+		if (ai_will_search_for_enemy(objp))
+			Ai_target_prediction_objnums.push_back(so->objnum);
+	}
+
+	// The searches only read the world state, apart from clearing stale ignore entries of the searching ship
+	pool.parallel_for(Ai_target_prediction_objnums.size(), 1, [](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			ai_predict_target(Ai_target_prediction_objnums[i]);
+		}
+	});
+}
+
 /**
  * If *objp is recovering from a collision with a big ship, handle it.
  * @return true if recovering.
@@ -14702,6 +14872,8 @@ int Last_ai_obj = -1;
 
 void ai_process( object * obj, int ai_index, float frametime )
 {
+	TRACE_SCOPE(tracing::AIProcess);
+
 	if (obj->flags[Object::Object_Flags::Should_be_dead])
 		return;
 
@@ -15220,6 +15392,7 @@ void maybe_process_friendly_hit(object *objp_hitter, object *objp_hit, object *o
 			ai_abort_rearm_request( Player_obj );
 
 			Player_ship->team = Iff_traitor;
+			obj_spatial_invalidate();
 
 		} else if ((damage > frand()) && (Missiontime - pp->last_warning_message_time > F1_0*4) && (pp->friendly_damage > FRIENDLY_DAMAGE_THRESHOLD)) {
 			// no closer than 4 sec intervals
@@ -34,4 +34,9 @@ bool check_los(int objnum, int target_objnum, float threshold, int primary_bank,
 //Does all the stuff needed to aim and fire a turret.
 void ai_turret_execute_behavior(ship *shipp, ship_subsys *ss);
 
+//Lets all turrets of a ship share the target search work which only depends on the ship.  Everything that
+//runs the turrets of a ship in one go should wrap the turret updates in these.
+void ai_turret_batch_begin(int parent_objnum);
+void ai_turret_batch_end();
+
 #endif
@@ -14,6 +14,7 @@
 #include "network/multi.h"
 #include "network/multimsgs.h"
 #include "object/objectdock.h"
+#include "object/objectspatial.h"
 #include "scripting/scripting.h"
 #include "render/3d.h"
 #include "ship/ship.h"
@@ -25,6 +26,7 @@
 #include "weapon/swarm.h"
 #include "weapon/weapon.h"
 
+#include <algorithm>
 #include <climits>
 
 
@@ -478,6 +480,138 @@ int valid_turret_enemy(object *objp, object *turret_parent)
 	return 0;
 }
 
+// Target search state shared by all turrets of the ship process_subobjects() is working on.  Everything in here only
+// depends on the parent ship and on the other ships, and none of that changes while the turrets of one ship are run,
+// so it is worked out once per ship instead of once per turret.
+typedef struct turret_ship_batch {
+	int parent_objnum = -1;					// -1 if no batch is active
+	int enemy_team_mask = 0;
+
+	bool candidates_valid = false;
+	SCP_vector<int> candidates;				// enemy ships valid_turret_enemy() accepts, in Ship_obj_list order
+
+	bool fighters_valid = false;
+	SCP_vector<vec3d> enemy_fighter_pos;	// positions of the enemy fighters and bombers
+
+	SCP_vector<int> targetable;				// object_is_targetable() results by objnum, -1 if not known yet
+	SCP_vector<int> targetable_objnums;		// objnums which have a result in targetable
+} turret_ship_batch;
+
+static turret_ship_batch Turret_ship_batch;
+
+void ai_turret_batch_begin(int parent_objnum)
+{
+	auto batch = &Turret_ship_batch;
+
+	batch->parent_objnum = parent_objnum;
+	batch->enemy_team_mask = iff_get_attackee_mask(obj_team(&Objects[parent_objnum]));
+	batch->candidates_valid = false;
+	batch->fighters_valid = false;
+
+	if (batch->targetable.empty()) {
+		batch->targetable.assign(MAX_OBJECTS, -1);
+	}
+	for (auto objnum : batch->targetable_objnums) {
+		batch->targetable[objnum] = -1;
+	}
+	batch->targetable_objnums.clear();
+}
+
+void ai_turret_batch_end()
+{
+	Turret_ship_batch.parent_objnum = -1;
+}
+
+static bool turret_batch_active(int parent_objnum, int enemy_team_mask)
+{
+	return Turret_ship_batch.parent_objnum == parent_objnum && Turret_ship_batch.enemy_team_mask == enemy_team_mask;
+}
+
+/**
+ * Appends the ships a turret of the parent ship may consider as targets.  Ships which are not in enemy_team_mask or
+ * which valid_turret_enemy() rejects may be left out since evaluate_obj_as_target() would not consider them anyway.
+ */
+static void turret_get_ship_candidates(int parent_objnum, int enemy_team_mask, SCP_vector<int> &candidates)
+{
+	auto batch = &Turret_ship_batch;
+
+	if (!turret_batch_active(parent_objnum, enemy_team_mask)) {
+		obj_spatial_query_team_ships(enemy_team_mask, candidates);
+		return;
+	}
+
+	if (!batch->candidates_valid) {
+		batch->candidates.clear();
+		obj_spatial_query_team_ships(enemy_team_mask, batch->candidates);
+
+		object *parent_objp = &Objects[parent_objnum];
+		auto new_end = std::remove_if(batch->candidates.begin(), batch->candidates.end(),
+			[parent_objp](int objnum) { return !valid_turret_enemy(&Objects[objnum], parent_objp); });
+		batch->candidates.erase(new_end, batch->candidates.end());
+
+		batch->candidates_valid = true;
+	}
+
+	candidates.insert(candidates.end(), batch->candidates.begin(), batch->candidates.end());
+}
+
+/**
+ * object_is_targetable() for a turret of the given parent ship, cached for the ship batch since the AWACS and nebula
+ * checks behind it are the same for all turrets of a ship.
+ */
+static int turret_object_is_targetable(object *objp, object *turret_parent_obj)
+{
+	auto batch = &Turret_ship_batch;
+	int objnum = OBJ_INDEX(objp);
+
+	if (batch->parent_objnum != OBJ_INDEX(turret_parent_obj)) {
+		return object_is_targetable(objp, &Ships[turret_parent_obj->instance]);
+	}
+
+	if (batch->targetable[objnum] < 0) {
+		batch->targetable[objnum] = object_is_targetable(objp, &Ships[turret_parent_obj->instance]) ? 1 : 0;
+		batch->targetable_objnums.push_back(objnum);
+	}
+
+	return batch->targetable[objnum];
+}
+
+/**
+ * Number of fighters and bombers of an enemy team of the parent ship within threshold of pos, same as
+ * num_nearby_fighters().
+ */
+static int turret_num_nearby_fighters(object *turret_parent_obj, vec3d *pos, float threshold)
+{
+	auto batch = &Turret_ship_batch;
+	int enemy_team_mask = iff_get_attackee_mask(obj_team(turret_parent_obj));
+
+	if (!turret_batch_active(OBJ_INDEX(turret_parent_obj), enemy_team_mask)) {
+		return num_nearby_fighters(enemy_team_mask, pos, threshold);
+	}
+
+	if (!batch->fighters_valid) {
+		batch->enemy_fighter_pos.clear();
+		for (ship_obj *so = GET_FIRST(&Ship_obj_list); so != END_OF_LIST(&Ship_obj_list); so = GET_NEXT(so)) {
+			object *ship_objp = &Objects[so->objnum];
+			ship *shipp = &Ships[ship_objp->instance];
+
+			if (iff_matches_mask(shipp->team, enemy_team_mask) && Ship_info[shipp->ship_info_index].is_fighter_bomber()) {
+				batch->enemy_fighter_pos.push_back(ship_objp->pos);
+			}
+		}
+		batch->fighters_valid = true;
+	}
+
+	int count = 0;
+	for (auto &fighter_pos : batch->enemy_fighter_pos) {
+		if (vm_vec_dist_quick(pos, &fighter_pos) < threshold) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
 extern int Player_attacking_enabled;
 void evaluate_obj_as_target(object *objp, eval_enemy_obj_struct *eeo)
 {
@@ -574,7 +708,7 @@ void evaluate_obj_as_target(object *objp, eval_enemy_obj_struct *eeo)
 		}
 
 		// check if valid target in nebula
-		if ( !object_is_targetable(objp, &Ships[Objects[eeo->turret_parent_objnum].instance]) ) {
+		if ( !turret_object_is_targetable(objp, turret_parent_obj) ) {
 			// BYPASS ocassionally for stealth
 			int try_anyway = FALSE;
 			if ( is_object_stealth_ship(objp) ) {
@@ -770,7 +904,6 @@ int get_nearest_turret_objnum(int turret_parent_objnum, ship_subsys *turret_subs
 	ship_weapon *swp = &turret_subsys->weapons;
 
 	// list of stuff to go thru
-	ship_obj		*so;
 	missile_obj *mo;
 
 	//wip=&Weapon_info[tp->turret_weapon_type];
@@ -1013,10 +1146,14 @@ int get_nearest_turret_objnum(int turret_parent_objnum, ship_subsys *turret_subs
 
 				case 1:
 					//Return if a ship is found
-					// Ship_used_list
-					for ( so = GET_FIRST(&Ship_obj_list); so != END_OF_LIST(&Ship_obj_list); so = GET_NEXT(so) ) {
-						objp = &Objects[so->objnum];
-						evaluate_obj_as_target(objp, &eeo);
+					// ships of other teams are rejected by evaluate_obj_as_target anyway
+					{
+						SCP_vector<int> candidates;
+						turret_get_ship_candidates(turret_parent_objnum, eeo.enemy_team_mask, candidates);
+						for (int candidate : candidates) {
+							objp = &Objects[candidate];
+							evaluate_obj_as_target(objp, &eeo);
+						}
 					}
 
 					// next highest priority is attacking ship
@@ -2245,7 +2382,7 @@ void ai_turret_execute_behavior(ship *shipp, ship_subsys *ss)
 	}
 
 	// count the number of enemies, in case we have a spawning weapon
-	int num_ships_nearby = num_nearby_fighters(iff_get_attackee_mask(obj_team(objp)), &gpos, 1500.0f);
+	int num_ships_nearby = turret_num_nearby_fighters(objp, &gpos, 1500.0f);
 
 	// some flags considering there may be different weapon types on this turret
 	bool we_did_non_spawning_logic = false;
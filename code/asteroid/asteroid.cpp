@@ -1023,9 +1023,11 @@ int asteroid_check_collision(object *pasteroid, object *other_obj, vec3d *hitpos
 
 					// find the start and end positions of the sphere in submodel RF
 					smi->canonical_orient = smi->canonical_prev_orient;
+					submodel_instance_orient_changed(smi);
 					world_find_model_instance_point(&p0, &light_obj->last_pos, pm, pmi, submodel, &heavy_obj->last_orient, &heavy_obj->last_pos);
 
 					smi->canonical_orient = copy_matrix;
+					submodel_instance_orient_changed(smi);
 					world_find_model_instance_point(&p1, &light_obj->pos, pm, pmi, submodel, &heavy_obj->orient, &heavy_obj->pos);
 
 					mc.p0 = &p0;
@@ -2525,6 +2525,72 @@ void bm_page_in_aabitmap(int handle, int nframes) {
 	}
 }
 
+/**
+ * The file bm_lock() reads the image of a bitmap from, or an empty string if the bitmap is not read from its own file
+ */
+static SCP_string bm_get_image_filename(const bitmap_entry& entry) {
+	const char* filename = (entry.type == BM_TYPE_EFF) ? entry.info.ani.eff.filename : entry.filename;
+	BM_TYPE type = (entry.type == BM_TYPE_EFF) ? entry.info.ani.eff.type : entry.type;
+
+	const char* ext;
+	switch (type) {
+	case BM_TYPE_PCX:
+		ext = ".pcx";
+		break;
+	case BM_TYPE_TGA:
+		ext = ".tga";
+		break;
+	case BM_TYPE_PNG:
+		// all frames of an APNG are in the file of the first frame
+		if (entry.info.ani.apng.is_apng) {
+			return SCP_string();
+		}
+		ext = ".png";
+		break;
+	case BM_TYPE_JPG:
+		ext = ".jpg";
+		break;
+	case BM_TYPE_DDS:
+	case BM_TYPE_DXT1:
+	case BM_TYPE_DXT3:
+	case BM_TYPE_DXT5:
+	case BM_TYPE_BC7:
+	case BM_TYPE_CUBEMAP_DDS:
+	case BM_TYPE_CUBEMAP_DXT1:
+	case BM_TYPE_CUBEMAP_DXT3:
+	case BM_TYPE_CUBEMAP_DXT5:
+		ext = ".dds";
+		break;
+	default:
+		return SCP_string();
+	}
+
+	// the image readers replace the extension the same way
+	SCP_string name = filename;
+	auto dot = name.find('.');
+	if (dot != SCP_string::npos) {
+		name.resize(dot);
+	}
+
+	return name + ext;
+}
+
+/**
+ * Reads the image files of the next few bitmaps bm_page_in_stop() loads on the worker threads
+ */
+static void bm_prefetch_images(const SCP_vector<std::pair<int, SCP_string>>& images, size_t begin, size_t end) {
+	SCP_map<int, SCP_vector<SCP_string>> by_dir_type;
+	for (size_t i = begin; i < end; ++i) {
+		if (!images[i].second.empty()) {
+			by_dir_type[images[i].first].push_back(images[i].second);
+		}
+	}
+
+	for (auto& files : by_dir_type) {
+		cf_prefetch_files(files.second, files.first);
+	}
+}
+
 void bm_page_in_start() {
 	Bm_paging = 1;
 
@@ -2559,6 +2625,21 @@ void bm_page_in_stop() {
 
 	int bm_preloading = 1;
 
+	// The image files are read ahead in batches on the worker threads while the bitmaps are loaded here
+	const size_t prefetch_batch = 64;
+	SCP_vector<std::pair<int, SCP_string>> images;
+	for (auto& block : bm_blocks) {
+		for (auto& slot : block) {
+			auto& entry = slot.entry;
+
+			if ((entry.type != BM_TYPE_NONE) && (entry.type != BM_TYPE_RENDER_TARGET_DYNAMIC)
+				&& (entry.type != BM_TYPE_RENDER_TARGET_STATIC) && entry.preloaded) {
+				images.emplace_back(entry.dir_type, (entry.bm.data == 0) ? bm_get_image_filename(entry) : SCP_string());
+			}
+		}
+	}
+	size_t image_index = 0;
+
 	for (auto& block : bm_blocks) {
 		for (auto& slot : block) {
 			auto& entry = slot.entry;
@@ -2567,6 +2648,13 @@ void bm_page_in_stop() {
 				&& (entry.type != BM_TYPE_RENDER_TARGET_STATIC)) {
 				if (entry.preloaded) {
 					TRACE_SCOPE(tracing::PageInSingleBitmap);
+
+					if (image_index % prefetch_batch == 0) {
+						cf_prefetch_clear();
+						bm_prefetch_images(images, image_index, MIN(image_index + prefetch_batch, images.size()));
+					}
+					++image_index;
+
 					if (bm_preloading) {
 						if (!gr_preload(entry.handle, (entry.preloaded == 2))) {
 							mprintf(("Out of VRAM.  Done preloading.\n"));
@@ -2603,6 +2691,8 @@ void bm_page_in_stop() {
 		}
 	}
 
+	cf_prefetch_clear();
+
 	nprintf(("BmpInfo", "BMPMAN: Loaded %d bitmaps that are marked as used for this level.\n", n));
 
 #ifndef NDEBUG
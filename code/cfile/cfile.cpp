@@ -30,13 +30,17 @@
 
 #include "cfile/cfile.h"
 #include "cfile/cfilearchive.h"
+#include "cfile/cfilecompression.h"
 #include "cfile/cfilesystem.h"
 #include "osapi/osapi.h"
 #include "parse/encrypt.h"
+#include "utils/ThreadPool.h"
 #include "cfilesystem.h"
 
 
+#include <algorithm>
 #include <limits>
+#include <mutex>
 
 char Cfile_root_dir[CFILE_ROOT_DIRECTORY_LEN] = "";
 char Cfile_user_dir[CFILE_ROOT_DIRECTORY_LEN] = "";
@@ -105,6 +109,29 @@ std::array<CFILE, MAX_CFILE_BLOCKS> Cfile_block_list;
 
 static const char *Cfile_cdrom_dir = NULL;
 
+// Pack files are mapped into memory the first time a file is opened from them and stay mapped until cfile_close(), so
+// the files inside them can be read straight out of the mapping instead of through a FILE*.
+struct cf_pack_mapping {
+	const ubyte* data = nullptr;	// nullptr if the pack file could not be mapped
+	size_t length = 0;
+#ifdef _WIN32
+	HANDLE hInFile = INVALID_HANDLE_VALUE;
+	HANDLE hMapFile = nullptr;
+#endif
+};
+
+static SCP_unordered_map<SCP_string, cf_pack_mapping> Cfile_pack_mappings;
+static std::mutex Cfile_pack_mappings_mutex;
+
+// A file read into memory by cf_prefetch_files()
+struct cf_prefetched_file {
+	CFileLocation location;
+	SCP_vector<ubyte> data;
+	bool valid = false;		// false if the file could not be read or is read out of a mapped pack file anyway
+};
+
+static SCP_vector<std::unique_ptr<cf_prefetched_file>> Cfile_prefetched;
+
 //
 // Function prototypes for internally-called functions
 //
@@ -120,6 +147,9 @@ static CFILE *cf_open_mapped_fill_cfblock(const char* source, int line, const ch
 #endif
 
 static void cf_chksum_long_init();
+static const void* cf_get_packed_data(const SCP_string& pack_path, size_t offset, size_t size);
+static void cf_unmap_pack_files();
+static const cf_prefetched_file* cf_find_prefetched(const CFileLocation& res);
 
 static void dump_opened_files()
 {
@@ -138,6 +168,9 @@ void cfile_close()
 
 	cf_free_secondary_filelist();
 
+	cf_prefetch_clear();
+	cf_unmap_pack_files();
+
 	cfile_inited = 0;
 }
 
@@ -804,12 +837,25 @@ CFILE *_cfopen_special(const char* source, int line, const CFileLocation &res, c
 		return NULL;
 	}
 
+	auto prefetched = cf_find_prefetched(res);
+	if (prefetched != nullptr && prefetched->valid) {
+		return cf_open_memory_fill_cfblock(source, line, res.name_ext.c_str(), prefetched->data.data(), res.size, dir_type);
+	}
+
 	// In-Memory files are a bit different from normal files so we need to handle them separately
 	if (res.data_ptr != nullptr) {
 		return cf_open_memory_fill_cfblock(source, line, res.name_ext.c_str(), res.data_ptr, res.size, dir_type);
 	}
 	else {
 		// "file_path" should already be a fully qualified path, so just try to open it
+		if (res.offset) {
+			// Read files in pack files straight out of the mapped pack file if possible
+			auto packed_data = cf_get_packed_data(res.full_name, res.offset, res.size);
+			if (packed_data != nullptr) {
+				return cf_open_memory_fill_cfblock(source, line, res.name_ext.c_str(), packed_data, res.size, dir_type);
+			}
+		}
+
 		FILE *fp = fopen(res.full_name.c_str(), "rb");
 
 		if (fp) {
@@ -1079,6 +1125,235 @@ static CFILE *cf_open_mapped_fill_cfblock(const char* source, int line, const ch
 	}
 }
 
+// Maps a pack file into memory. Returns a mapping without data if that fails, the file is then read through a FILE*.
+static cf_pack_mapping cf_map_pack_file(const SCP_string& pack_path)
+{
+	cf_pack_mapping mapping;
+
+	// Don't use up the address space of 32-bit builds with pack files which can be gigabytes large
+	if (sizeof(void*) < 8) {
+		return mapping;
+	}
+
+#if defined _WIN32
+	mapping.hInFile = CreateFile(pack_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (mapping.hInFile == INVALID_HANDLE_VALUE) {
+		return mapping;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(mapping.hInFile, &file_size) || file_size.QuadPart <= 0) {
+		CloseHandle(mapping.hInFile);
+		mapping.hInFile = INVALID_HANDLE_VALUE;
+		return mapping;
+	}
+
+	mapping.hMapFile = CreateFileMapping(mapping.hInFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping.hMapFile == NULL) {
+		CloseHandle(mapping.hInFile);
+		mapping.hInFile = INVALID_HANDLE_VALUE;
+		return mapping;
+	}
+
+	mapping.data = (const ubyte*)MapViewOfFile(mapping.hMapFile, FILE_MAP_READ, 0, 0, 0);
+	if (mapping.data == nullptr) {
+		CloseHandle(mapping.hMapFile);
+		CloseHandle(mapping.hInFile);
+		mapping.hMapFile = nullptr;
+		mapping.hInFile = INVALID_HANDLE_VALUE;
+		return mapping;
+	}
+	mapping.length = static_cast<size_t>(file_size.QuadPart);
+#elif defined SCP_UNIX
+	FILE* fp = fopen(pack_path.c_str(), "rb");
+	if (fp == nullptr) {
+		return mapping;
+	}
+
+	auto length = filelength(fileno(fp));
+	if (length > 0) {
+		void* data = mmap(nullptr, static_cast<size_t>(length), PROT_READ, MAP_SHARED, fileno(fp), 0);
+		if (data != MAP_FAILED) {
+			mapping.data   = static_cast<const ubyte*>(data);
+			mapping.length = static_cast<size_t>(length);
+		}
+	}
+
+	// the mapping stays valid after the file is closed
+	fclose(fp);
+#endif
+
+	if (mapping.data == nullptr) {
+		mprintf(("Could not map pack file %s into memory, reading it through regular file I/O.\n", pack_path.c_str()));
+	}
+
+	return mapping;
+}
+
+static void cf_unmap_pack_files()
+{
+	std::lock_guard<std::mutex> guard(Cfile_pack_mappings_mutex);
+
+	for (auto& entry : Cfile_pack_mappings) {
+		auto& mapping = entry.second;
+		if (mapping.data == nullptr) {
+			continue;
+		}
+
+#if defined _WIN32
+		UnmapViewOfFile(mapping.data);
+		CloseHandle(mapping.hMapFile);
+		CloseHandle(mapping.hInFile);
+#elif defined SCP_UNIX
+		// This const_cast is safe since the pointer returned by mmap was also non-const
+		munmap(const_cast<ubyte*>(mapping.data), mapping.length);
+#endif
+	}
+
+	Cfile_pack_mappings.clear();
+}
+
+// Returns a pointer to a file inside a pack file in the mapped pack file, or nullptr if it has to be read through a
+// FILE* because the pack file could not be mapped or the file is compressed.
+static const void* cf_get_packed_data(const SCP_string& pack_path, size_t offset, size_t size)
+{
+	const ubyte* pack_data;
+	size_t pack_length;
+	{
+		std::lock_guard<std::mutex> guard(Cfile_pack_mappings_mutex);
+
+		auto entry = Cfile_pack_mappings.find(pack_path);
+		if (entry == Cfile_pack_mappings.end()) {
+			entry = Cfile_pack_mappings.emplace(pack_path, cf_map_pack_file(pack_path)).first;
+		}
+
+		pack_data   = entry->second.data;
+		pack_length = entry->second.length;
+	}
+
+	if (pack_data == nullptr || offset > pack_length || size > pack_length - offset) {
+		return nullptr;
+	}
+
+	// The decompression code reads compressed files through their FILE*, same check as cf_check_compression()
+	if (size > 16) {
+		int header;
+		memcpy(&header, pack_data + offset, sizeof(header));
+		if (comp_check_header(INTEL_INT(header)) == COMP_HEADER_MATCH) {
+			return nullptr;
+		}
+	}
+
+	return pack_data + offset;
+}
+
+// Reads one prefetched file, this runs on the worker threads
+static void cf_prefetch_read(cf_prefetched_file& file)
+{
+	const auto& res = file.location;
+
+	if (res.offset) {
+		auto packed_data = static_cast<const ubyte*>(cf_get_packed_data(res.full_name, res.offset, res.size));
+		if (packed_data != nullptr) {
+			// Fault the pages in here so that opening the file later does not have to wait for the disk
+			const size_t page_size = 4096;
+			volatile ubyte sum = 0;
+			for (size_t i = 0; i < res.size; i += page_size) {
+				sum += packed_data[i];
+			}
+			return;
+		}
+	}
+
+	FILE* fp = fopen(res.full_name.c_str(), "rb");
+	if (fp == nullptr) {
+		return;
+	}
+
+	file.data.resize(res.size);
+	bool read = fseek(fp, (long)res.offset, SEEK_SET) == 0 && fread(file.data.data(), res.size, 1, fp) == 1;
+	fclose(fp);
+
+	// Compressed files are decoded through their FILE*, same check as cf_check_compression()
+	if (read && res.size > 16) {
+		int header;
+		memcpy(&header, file.data.data(), sizeof(header));
+		read = comp_check_header(INTEL_INT(header)) != COMP_HEADER_MATCH;
+	}
+
+	if (read) {
+		file.valid = true;
+	} else {
+		file.data = SCP_vector<ubyte>();
+	}
+}
+
+void cf_prefetch_files(const SCP_vector<SCP_string>& filenames, int dir_type, int ext_num, const char** ext_list)
+{
+	if (filenames.empty() || util::worker_pool().concurrency() <= 1) {
+		return;
+	}
+
+	// Finding the files uses the file list, which is only safe on this thread
+	size_t first = Cfile_prefetched.size();
+	for (auto& filename : filenames) {
+		CFileLocation res;
+		if (ext_list != nullptr) {
+			res = cf_find_file_location_ext(filename.c_str(), ext_num, ext_list, dir_type);
+		} else {
+			res = cf_find_file_location(filename.c_str(), dir_type);
+		}
+
+		// Files in memory need no prefetching
+		if (!res.found || res.size == 0 || res.data_ptr != nullptr || cf_find_prefetched(res) != nullptr) {
+			continue;
+		}
+
+		std::unique_ptr<cf_prefetched_file> file(new cf_prefetched_file());
+		file->location = res;
+		Cfile_prefetched.push_back(std::move(file));
+	}
+
+	auto read_files = [first](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			cf_prefetch_read(*Cfile_prefetched[first + i]);
+		}
+	};
+
+	// The pool may already be busy if this is called from a job, the files are then read when they are opened
+	if (!util::worker_pool().try_parallel_for(Cfile_prefetched.size() - first, 1, read_files)) {
+		Cfile_prefetched.resize(first);
+	}
+}
+
+void cf_prefetch_clear()
+{
+	auto still_open = [](const cf_prefetched_file& file) {
+		for (auto& cfile : Cfile_block_list) {
+			if (cfile.type != CFILE_BLOCK_UNUSED && !file.data.empty() && cfile.data == file.data.data()) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	Cfile_prefetched.erase(std::remove_if(Cfile_prefetched.begin(), Cfile_prefetched.end(),
+	                                      [&](const std::unique_ptr<cf_prefetched_file>& file) { return !still_open(*file); }),
+	                       Cfile_prefetched.end());
+}
+
+static const cf_prefetched_file* cf_find_prefetched(const CFileLocation& res)
+{
+	for (auto& file : Cfile_prefetched) {
+		if (file->location.offset == res.offset && file->location.size == res.size
+		    && file->location.full_name == res.full_name) {
+			return file.get();
+		}
+	}
+
+	return nullptr;
+}
+
 static CFILE *cf_open_memory_fill_cfblock(const char* source, int line, const char* original_filename, const void* data, size_t size, int dir_type)
 {
 	int cfile_block_index;
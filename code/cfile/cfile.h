@@ -196,6 +196,16 @@ CFILE *_cfopen_special(const char* source_file, int line, const CFileLocation &r
 	                   int dir_type = CF_TYPE_ANY);
 #define cfopen_special(...) _cfopen_special(LOCATION, __VA_ARGS__) // Pass source location to the function
 
+// Reads the files into memory in parallel on the worker pool, so that loading a level does not have to wait for the
+// disk one file at a time. Opening one of these files for reading is served from memory until cf_prefetch_clear().
+// Files in mapped pack files are not copied, their pages are only touched. Does nothing without worker threads.
+// If ext_list is given the filenames are searched for like cf_find_file_location_ext() does.
+void cf_prefetch_files(const SCP_vector<SCP_string>& filenames, int dir_type, int ext_num = 0,
+                       const char** ext_list = nullptr);
+
+// Frees the prefetched files that are not open anymore
+void cf_prefetch_clear();
+
 // Flush the open file buffer
 int cflush(CFILE *cfile);
 
@@ -72,12 +72,16 @@ void cf_clear_compression_info(CFILE* cfile)
 	{
 		free(cfile->compression_info.offsets);
 		free(cfile->compression_info.decoder_buffer);
+		free(cfile->compression_info.window_block_bytes);
 		cfile->compression_info.offsets = nullptr;
 		cfile->compression_info.decoder_buffer = nullptr;
+		cfile->compression_info.window_block_bytes = nullptr;
 		cfile->compression_info.header = 0;
 		cfile->compression_info.block_size = 0;
-		cfile->compression_info.last_decoded_block_pos = 0;
-		cfile->compression_info.last_decoded_block_bytes = 0;
+		cfile->compression_info.window_capacity = 0;
+		cfile->compression_info.window_first_block = 0;
+		cfile->compression_info.window_num_blocks = 0;
+		cfile->compression_info.next_read_position = 0;
 		cfile->compression_info.num_offsets = 0;
 	}
 }
@@ -269,10 +273,10 @@ int cfread_lua_number(double *buf, CFILE *cfile)
 	if(buf == NULL)
 		return 0;
 
-	// cfread() not supported for memory-mapped files
-	if(cfile->data != nullptr)
+	// not supported for memory-mapped files
+	if(cfile->mem_mapped)
 	{
-		Warning(LOCATION, "Writing is not supported for mem-mapped files");
+		Warning(LOCATION, "Reading numbers is not supported for mem-mapped files");
 		return 0;
 	}
 
@@ -283,15 +287,21 @@ int cfread_lua_number(double *buf, CFILE *cfile)
 		items_read = fscanf(cfile->fp, LUA_NUMBER_SCAN, buf);
 		advance = (size_t) (ftell(cfile->fp)-orig_pos);
 	} else {
-		int read;
+		// The data is not null terminated so scan a terminated copy of the part which can hold the number
+		char number[128];
+		size_t length = MIN(sizeof(number) - 1, cfile->size - cfile->raw_position);
+		memcpy(number, reinterpret_cast<const char*>(cfile->data) + cfile->raw_position, length);
+		number[length] = '\0';
+
+		int read = 0;
 		// %n returns the number of bytes currently read so we append that to the scan format at the end so it will return
-		// how many bytes we have consumed
-		items_read = sscanf(reinterpret_cast<const char*>(cfile->data), LUA_NUMBER_SCAN "%n", buf, &read);
-		if (items_read == 2) {
-			// We need to correct the items read counter since we read one additional item
-			items_read = 1;
+		// how many bytes we have consumed. It does not count as a read item.
+		items_read = sscanf(number, LUA_NUMBER_SCAN "%n", buf, &read);
+		if (items_read == 1) {
+			advance = (size_t) read;
+		} else if (length == 0) {
+			items_read = EOF;
 		}
-		advance = (size_t) read;
 	}
 	cfile->raw_position += advance;
 	Assertion(cfile->raw_position <= cfile->size, "Invalid raw_position value detected!");
@@ -28,9 +28,12 @@ struct COMPRESSION_INFO {
 	int block_size = 0;
 	int num_offsets = 0;
 	int* offsets = nullptr;
-	char* decoder_buffer = nullptr;
-	int last_decoded_block_pos = 0;
-	int last_decoded_block_bytes = 0;
+	char* decoder_buffer = nullptr;		// the decoded blocks of the window, block_size bytes for each block
+	int* window_block_bytes = nullptr;	// the decoded size of each block in the window
+	int window_capacity = 0;			// the number of blocks decoder_buffer has room for
+	int window_first_block = 0;
+	int window_num_blocks = 0;
+	size_t next_read_position = 0;		// where the next read of a sequential reader starts
 };
 
 struct CFILE {
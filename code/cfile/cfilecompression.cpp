@@ -14,6 +14,13 @@
 #include "lz4.h"
 #include "cfilecompression.h"
 #include "cfilearchive.h"
+#include "utils/ThreadPool.h"
+
+#include <atomic>
+
+/*LZ41 read-ahead, a sequential reader gets the blocks after the one it reads decoded along with it in parallel*/
+#define LZ41_MAX_READ_AHEAD_BLOCKS 8
+#define LZ41_MAX_READ_AHEAD_BYTES (1024 * 1024)
 
 /*INTERNAL FUNCTIONS*/
 /*LZ41*/
@@ -130,9 +137,17 @@ void lz41_create_ci(CFILE* cf, int header)
 	Assertion(fBsize == 1, "Error while reading block size, compressed file is possibly in the wrong format or corrupted.");
 	#endif
 
-	cf->compression_info.decoder_buffer = (char*)malloc(LZ4_compressBound(cf->compression_info.block_size));
-	cf->compression_info.last_decoded_block_pos = 0;
-	cf->compression_info.last_decoded_block_bytes = 0;
+	/* Only decode ahead if there are worker threads to do it */
+	int read_ahead = 0;
+	if (util::worker_pool().concurrency() > 1)
+		read_ahead = MIN(LZ41_MAX_READ_AHEAD_BLOCKS, LZ41_MAX_READ_AHEAD_BYTES / cf->compression_info.block_size);
+
+	cf->compression_info.window_capacity = 1 + read_ahead;
+	cf->compression_info.decoder_buffer = (char*)malloc((size_t)cf->compression_info.window_capacity * cf->compression_info.block_size);
+	cf->compression_info.window_block_bytes = (int*)malloc(cf->compression_info.window_capacity * sizeof(int));
+	cf->compression_info.window_first_block = 0;
+	cf->compression_info.window_num_blocks = 0;
+	cf->compression_info.next_read_position = 0;
 	lz41_load_offsets(cf);
 }
 
@@ -151,56 +166,132 @@ void lz41_load_offsets(CFILE* cf)
 	}
 }
 
+/* The size a block decodes to, only the last block can be shorter than the block size */
+static int lz41_block_bytes(CFILE* cf, int block)
+{
+	size_t block_start = (size_t)block * cf->compression_info.block_size;
+	if (block_start >= cf->size)
+		return 0;
+
+	return (int)MIN((size_t)cf->compression_info.block_size, cf->size - block_start);
+}
+
+/*
+	Reads the compressed blocks first_block to end_block with a single read and decodes them. The first num_direct blocks
+	are decoded straight into bytes_out, the others replace the contents of the window. The blocks are independent of
+	each other, so they are decoded in parallel if the worker pool is free.
+*/
+static bool lz41_decode_blocks(CFILE* cf, int first_block, int end_block, int num_direct, char* bytes_out)
+{
+	auto& ci = cf->compression_info;
+	int num_blocks = end_block - first_block;
+
+	size_t cmp_bytes = (size_t)(ci.offsets[end_block] - ci.offsets[first_block]);
+	char* cmp_buf = (char*)malloc(cmp_bytes);
+
+	fso_fseek(cf, ci.offsets[first_block], SEEK_SET);
+	auto bytes_read = fread(cmp_buf, cmp_bytes, 1, cf->fp);
+	Assertion(bytes_read == 1, "Error reading from compressed file.");
+
+	/* The window is overwritten from here on, it only becomes valid again if everything decoded */
+	bool fills_window = num_direct < num_blocks;
+	if (fills_window)
+		ci.window_num_blocks = 0;
+
+	std::atomic<bool> failed(bytes_read != 1);
+	auto decode = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			int block = first_block + (int)i;
+			const char* src = cmp_buf + (ci.offsets[block] - ci.offsets[first_block]);
+			int src_bytes = ci.offsets[block + 1] - ci.offsets[block];
+
+			if ((int)i < num_direct) {
+				int expected = lz41_block_bytes(cf, block);
+				if (LZ4_decompress_safe(src, bytes_out + i * ci.block_size, src_bytes, expected) != expected)
+					failed = true;
+			} else {
+				int window_index = (int)i - num_direct;
+				int decoded = LZ4_decompress_safe(src, ci.decoder_buffer + (size_t)window_index * ci.block_size, src_bytes, ci.block_size);
+				ci.window_block_bytes[window_index] = decoded;
+				if (decoded <= 0)
+					failed = true;
+			}
+		}
+	};
+
+	if (failed || num_blocks < 2 || !util::worker_pool().try_parallel_for((size_t)num_blocks, 1, decode))
+		decode(0, (size_t)num_blocks);
+
+	free(cmp_buf);
+
+	if (failed)
+		return false;
+
+	if (fills_window) {
+		ci.window_first_block = first_block + num_direct;
+		ci.window_num_blocks = num_blocks - num_direct;
+	}
+	return true;
+}
+
 size_t lz41_stream_random_access(CFILE* cf, char* bytes_out, size_t offset, size_t length)
 {
-	LZ4_streamDecode_t lz4_stream_decode_body;
-	LZ4_streamDecode_t* lz4_stream_decode = &lz4_stream_decode_body;
+	auto& ci = cf->compression_info;
 	/* The blocks (current_block to end_block) contain the data we want */
-	size_t current_block = offset / cf->compression_info.block_size;
-	size_t end_block = ((offset + length - 1) / cf->compression_info.block_size) + 1;
+	int current_block = (int)(offset / ci.block_size);
+	int end_block = (int)((offset + length - 1) / ci.block_size) + 1;
 	size_t written_bytes = 0;
 
-	if (cf->compression_info.num_offsets <= (int)end_block)
+	if (ci.num_offsets <= end_block)
 		return (size_t)LZ41_OFFSETS_MISMATCH;
 
-	/* Seek to the first block to read, if it matches the cached block, search the next one instead */
-	if (cf->compression_info.last_decoded_block_pos == cf->compression_info.offsets[current_block] && current_block + 1 <= end_block)
-		fso_fseek(cf, cf->compression_info.offsets[current_block+1], SEEK_SET);
-	else
-		fso_fseek(cf, cf->compression_info.offsets[current_block], SEEK_SET);
-	
-	offset = offset % cf->compression_info.block_size;
-	char* cmp_buf = (char*)malloc(LZ4_compressBound(cf->compression_info.block_size));
+	/* Decoding ahead only pays off for readers that continue where they stopped */
+	bool sequential = offset == ci.next_read_position;
+	ci.next_read_position = offset + length;
 
-	/* Start decoding */
-	for (; current_block < end_block; ++current_block)
+	offset = offset % ci.block_size;
+
+	while (current_block < end_block)
 	{
-		/* Only read and decode if the requested block is not the cached one */
-		if (cf->compression_info.last_decoded_block_pos != cf->compression_info.offsets[current_block])
+		if (current_block < ci.window_first_block || current_block >= ci.window_first_block + ci.window_num_blocks)
 		{
-			cf->compression_info.last_decoded_block_pos = cf->compression_info.offsets[current_block];
+			/* Blocks the read covers completely are decoded straight into bytes_out */
+			int direct_end = current_block;
+			size_t direct_bytes = 0;
+			if (offset == 0) {
+				while (direct_end < end_block && direct_bytes + lz41_block_bytes(cf, direct_end) <= length) {
+					direct_bytes += lz41_block_bytes(cf, direct_end);
+					++direct_end;
+				}
+			}
 
-			/* The difference in offsets is the size of the block */
-			int cmp_bytes = cf->compression_info.offsets[current_block + 1] - cf->compression_info.offsets[current_block];
-			auto bytes_read = fread(cmp_buf, cmp_bytes, 1, cf->fp);
-			Assertion(bytes_read == 1, "Error reading from compressed file.");
+			/* The rest of the read goes through the window, along with the blocks after it for sequential readers */
+			int window_end = direct_end;
+			if (direct_end < end_block)
+				window_end = MIN(direct_end + (sequential ? ci.window_capacity : 1), ci.num_offsets - 1);
 
-			cf->compression_info.last_decoded_block_bytes = LZ4_decompress_safe_continue(lz4_stream_decode, cmp_buf, cf->compression_info.decoder_buffer, cmp_bytes, cf->compression_info.block_size);
-			if (cf->compression_info.last_decoded_block_bytes <= 0)
-			{
-				free(cmp_buf);
+			if (!lz41_decode_blocks(cf, current_block, window_end, direct_end - current_block, bytes_out + written_bytes))
 				return (size_t)LZ41_DECOMPRESSION_ERROR;
-			}
+
+			written_bytes += direct_bytes;
+			length -= direct_bytes;
+			current_block = direct_end;
+			continue;
 		}
 
-		/* Write out the part of the data we care about from buffer */
-		size_t block_length = (length < (cf->compression_info.last_decoded_block_bytes - offset) ? length : (cf->compression_info.last_decoded_block_bytes - offset));
-		memcpy(bytes_out + written_bytes, cf->compression_info.decoder_buffer + offset, (size_t)block_length);
+		/* Write out the part of the data we care about from the window */
+		int window_index = current_block - ci.window_first_block;
+		size_t block_bytes = (size_t)ci.window_block_bytes[window_index];
+		if (offset >= block_bytes)
+			return (size_t)LZ41_DECOMPRESSION_ERROR;
+
+		size_t block_length = MIN(length, block_bytes - offset);
+		memcpy(bytes_out + written_bytes, ci.decoder_buffer + (size_t)window_index * ci.block_size + offset, block_length);
 		written_bytes += block_length;
 		offset = 0;
 		length -= block_length;
+		++current_block;
 	}
 
-	free(cmp_buf);
 	return written_bytes;
 }
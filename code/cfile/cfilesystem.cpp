@@ -21,6 +21,7 @@
 #include <direct.h>
 #include <windows.h>
 #include <winbase.h>		/* needed for memory mapping of file functions */
+#include <sys/stat.h>
 #endif
 
 #ifdef SCP_UNIX
@@ -101,6 +102,10 @@ typedef struct cf_file_block {
 static uint Num_files = 0;
 static cf_file_block  *File_blocks[CF_MAX_FILE_BLOCKS];
 
+// All files by their case insensitive name. Each entry holds the indices of all files with that name in ascending
+// order, which is the order of precedence in which cf_find_file_location() considers them.
+static SCP_unordered_map<SCP_string, SCP_vector<uint>, SCP_string_lcase_hash, SCP_string_lcase_equal_to> File_name_index;
+
 // Return a pointer to to file 'index'.
 cf_file *cf_get_file(int index)
 {
@@ -776,6 +781,235 @@ typedef struct VP_FILE {
 	_fs_time_t write_time;
 } VP_FILE;
 
+// The files found in the VP files are cached in a manifest in the user's cache directory so that unchanged VP files do
+// not have to be read again at the next start. A VP file is identified by its path, size and modification time.
+#define CF_PACK_MANIFEST_FILENAME	"vp_manifest.bin"
+#define CF_PACK_MANIFEST_ID			0x464D5056		// "VPMF"
+#define CF_PACK_MANIFEST_VERSION	1
+
+typedef struct cf_pack_manifest_file {
+	SCP_string	name_ext;
+	int			pathtype_index;
+	int64_t		write_time;
+	int			size;
+	int			pack_offset;
+} cf_pack_manifest_file;
+
+typedef struct cf_pack_manifest_entry {
+	int64_t		pack_size;
+	int64_t		pack_mtime;
+	SCP_vector<cf_pack_manifest_file> files;
+} cf_pack_manifest_entry;
+
+static SCP_unordered_map<SCP_string, cf_pack_manifest_entry> Pack_manifest;
+static bool Pack_manifest_changed = false;
+
+// The path types decide which files of a VP file are used, so a manifest written with other path types is useless
+static uint cf_pack_manifest_pathtypes_hash()
+{
+	uint hash = 2166136261u;
+	auto add = [&hash](const char *str) {
+		for (; str != nullptr && *str != '\0'; ++str) {
+			hash = (hash ^ (ubyte)*str) * 16777619u;
+		}
+		hash = (hash ^ 0xFF) * 16777619u;
+	};
+
+	for (auto &pathtype : Pathtypes) {
+		add(pathtype.path);
+		add(pathtype.extensions);
+	}
+
+	return hash;
+}
+
+static bool cf_pack_manifest_path(char *path, uint path_max)
+{
+	if (Cmdline_no_vp_manifest) {
+		return false;
+	}
+
+	cf_create_default_path_string(path, path_max, CF_TYPE_CACHE, CF_PACK_MANIFEST_FILENAME, false,
+	                              CF_LOCATION_ROOT_USER | CF_LOCATION_ROOT_GAME | CF_LOCATION_TYPE_ROOT);
+
+	// without a path root there is nowhere to put the manifest
+	return strchr(path, DIR_SEPARATOR_CHAR) != nullptr;
+}
+
+static bool cf_get_pack_stat(const char *pack_path, int64_t *size, int64_t *mtime)
+{
+#ifdef _WIN32
+	struct _stat64 st;
+	if (_stat64(pack_path, &st) != 0) {
+		return false;
+	}
+#else
+	struct stat st;
+	if (stat(pack_path, &st) != 0) {
+		return false;
+	}
+#endif
+
+	*size = (int64_t)st.st_size;
+	*mtime = (int64_t)st.st_mtime;
+	return true;
+}
+
+// Reads the manifest from disk. Anything which does not look right makes it start out empty.
+static void cf_load_pack_manifest()
+{
+	Pack_manifest.clear();
+	Pack_manifest_changed = false;
+
+	char path[CF_MAX_PATHNAME_LENGTH];
+	if (!cf_pack_manifest_path(path, sizeof(path) - 1)) {
+		return;
+	}
+
+	FILE *fp = fopen(path, "rb");
+	if (fp == nullptr) {
+		return;
+	}
+
+	SCP_vector<ubyte> buffer;
+	auto length = filelength(fileno(fp));
+	if (length > 0) {
+		buffer.resize((size_t)length);
+		if (fread(buffer.data(), 1, buffer.size(), fp) != buffer.size()) {
+			buffer.clear();
+		}
+	}
+	fclose(fp);
+
+	size_t pos = 0;
+	auto read = [&buffer, &pos](void *out, size_t size) {
+		if (size > buffer.size() - pos) {
+			return false;
+		}
+		memcpy(out, buffer.data() + pos, size);
+		pos += size;
+		return true;
+	};
+	auto read_string = [&read](SCP_string &out) {
+		uint len;
+		if (!read(&len, sizeof(len)) || len >= CF_MAX_PATHNAME_LENGTH) {
+			return false;
+		}
+		out.resize(len);
+		return len == 0 || read(&out[0], len);
+	};
+
+	uint header[4];
+	if (!read(header, sizeof(header)) || header[0] != CF_PACK_MANIFEST_ID || header[1] != CF_PACK_MANIFEST_VERSION
+		|| header[2] != cf_pack_manifest_pathtypes_hash()) {
+		return;
+	}
+
+	SCP_unordered_map<SCP_string, cf_pack_manifest_entry> manifest;
+	for (uint i = 0; i < header[3]; ++i) {
+		SCP_string pack_path;
+		cf_pack_manifest_entry entry;
+		uint num_files;
+
+		if (!read_string(pack_path) || !read(&entry.pack_size, sizeof(entry.pack_size))
+			|| !read(&entry.pack_mtime, sizeof(entry.pack_mtime)) || !read(&num_files, sizeof(num_files))) {
+			return;
+		}
+
+		// every file takes up at least 20 bytes
+		if (num_files > (buffer.size() - pos) / 20) {
+			return;
+		}
+
+		entry.files.resize(num_files);
+		for (auto &file : entry.files) {
+			if (!read_string(file.name_ext) || file.name_ext.size() >= CF_MAX_FILENAME_LENGTH
+				|| !read(&file.pathtype_index, sizeof(file.pathtype_index)) || !read(&file.write_time, sizeof(file.write_time))
+				|| !read(&file.size, sizeof(file.size)) || !read(&file.pack_offset, sizeof(file.pack_offset))) {
+				return;
+			}
+
+			if (file.pathtype_index < CF_TYPE_ROOT || file.pathtype_index >= CF_MAX_PATH_TYPES) {
+				return;
+			}
+		}
+
+		manifest[pack_path] = std::move(entry);
+	}
+
+	Pack_manifest = std::move(manifest);
+}
+
+// Writes the manifest back if any VP file had to be read
+static void cf_save_pack_manifest()
+{
+	if (!Pack_manifest_changed) {
+		return;
+	}
+	Pack_manifest_changed = false;
+
+	char path[CF_MAX_PATHNAME_LENGTH];
+	if (!cf_pack_manifest_path(path, sizeof(path) - 1)) {
+		return;
+	}
+
+	cf_create_directory(CF_TYPE_CACHE, CF_LOCATION_ROOT_USER | CF_LOCATION_ROOT_GAME | CF_LOCATION_TYPE_ROOT);
+
+	// drop VP files which are gone so that the manifest doesn't keep growing
+	SCP_vector<const SCP_unordered_map<SCP_string, cf_pack_manifest_entry>::value_type *> entries;
+	for (auto &entry : Pack_manifest) {
+		int64_t size, mtime;
+		if (cf_get_pack_stat(entry.first.c_str(), &size, &mtime)) {
+			entries.push_back(&entry);
+		}
+	}
+
+	FILE *fp = fopen(path, "wb");
+	if (fp == nullptr) {
+		mprintf(("Could not write VP manifest '%s'.\n", path));
+		return;
+	}
+
+	bool ok = true;
+	auto write = [fp, &ok](const void *data, size_t size) {
+		if (ok && size > 0) {
+			ok = fwrite(data, size, 1, fp) == 1;
+		}
+	};
+	auto write_string = [&write](const SCP_string &str) {
+		uint len = (uint)str.size();
+		write(&len, sizeof(len));
+		write(str.data(), len);
+	};
+
+	uint header[4] = { CF_PACK_MANIFEST_ID, CF_PACK_MANIFEST_VERSION, cf_pack_manifest_pathtypes_hash(), (uint)entries.size() };
+	write(header, sizeof(header));
+
+	for (auto entry : entries) {
+		uint num_files = (uint)entry->second.files.size();
+
+		write_string(entry->first);
+		write(&entry->second.pack_size, sizeof(entry->second.pack_size));
+		write(&entry->second.pack_mtime, sizeof(entry->second.pack_mtime));
+		write(&num_files, sizeof(num_files));
+
+		for (auto &file : entry->second.files) {
+			write_string(file.name_ext);
+			write(&file.pathtype_index, sizeof(file.pathtype_index));
+			write(&file.write_time, sizeof(file.write_time));
+			write(&file.size, sizeof(file.size));
+			write(&file.pack_offset, sizeof(file.pack_offset));
+		}
+	}
+
+	fclose(fp);
+
+	if (!ok) {
+		mprintf(("Could not write VP manifest '%s'.\n", path));
+		remove(path);
+	}
+}
+
 void cf_search_root_pack(int root_index)
 {
 	int num_files = 0;
@@ -783,6 +1017,29 @@ void cf_search_root_pack(int root_index)
 
 	Assert( root != NULL );
 
+	// use the files found the last time if the VP file did not change since then
+	cf_pack_manifest_entry manifest_entry;
+	bool use_manifest = cf_get_pack_stat(root->path, &manifest_entry.pack_size, &manifest_entry.pack_mtime);
+
+	if (use_manifest) {
+		auto cached = Pack_manifest.find(root->path);
+		if (cached != Pack_manifest.end() && cached->second.pack_size == manifest_entry.pack_size
+			&& cached->second.pack_mtime == manifest_entry.pack_mtime) {
+			for (auto &cached_file : cached->second.files) {
+				cf_file *file = cf_create_file();
+				strcpy_s( file->name_ext, cached_file.name_ext.c_str() );
+				file->root_index = root_index;
+				file->pathtype_index = cached_file.pathtype_index;
+				file->write_time = (time_t)cached_file.write_time;
+				file->size = cached_file.size;
+				file->pack_offset = cached_file.pack_offset;
+			}
+
+			mprintf(( "Searching root pack '%s' ... %i files (cached)\n", root->path, (int)cached->second.files.size() ));
+			return;
+		}
+	}
+
 	// Open data		
 	FILE *fp = fopen( root->path, "rb" );
 	// Read the file header
@@ -868,6 +1125,10 @@ void cf_search_root_pack(int root_index)
 							file->size = find.size;
 							file->pack_offset = find.offset;			// Mark as a packed file
 
+							if (use_manifest) {
+								manifest_entry.files.push_back({ file->name_ext, j, (int64_t)find.write_time, find.size, find.offset });
+							}
+
 							num_files++;
 							//mprintf(( "Found pack file '%s'\n", file->name_ext ));
 						}
@@ -879,6 +1140,11 @@ void cf_search_root_pack(int root_index)
 
 	fclose(fp);
 
+	if (use_manifest) {
+		Pack_manifest[root->path] = std::move(manifest_entry);
+		Pack_manifest_changed = true;
+	}
+
 	mprintf(( "%i files\n", num_files ));
 }
 
@@ -931,6 +1197,8 @@ void cf_build_file_list()
 
 	Num_files = 0;
 
+	cf_load_pack_manifest();
+
 	// For each root, find all files...
 	for (i=0; i<Num_roots; i++ )	{
 		cf_root	*root = cf_get_root(i);
@@ -943,6 +1211,14 @@ void cf_build_file_list()
 		}
 	}
 
+	cf_save_pack_manifest();
+
+	// index the files by name so that lookups do not have to go through all of them
+	File_name_index.clear();
+	File_name_index.reserve(Num_files);
+	for (uint ui = 0; ui < Num_files; ui++) {
+		File_name_index[cf_get_file(ui)->name_ext].push_back(ui);
+	}
 }
 
 
@@ -1004,6 +1280,42 @@ void cf_free_secondary_filelist()
 		}
 	}
 	Num_files = 0;
+
+	File_name_index.clear();
+}
+
+/**
+ * Returns the index of the first file in the file list with the given name which is in a matching path type and root,
+ * or Num_files if there is none.
+ */
+static uint cf_find_indexed_file(const char *name_ext, int pathtype, uint32_t location_flags)
+{
+	auto entry = File_name_index.find(name_ext);
+	if (entry == File_name_index.end()) {
+		return Num_files;
+	}
+
+	for (auto ui : entry->second) {
+		cf_file *f = cf_get_file(ui);
+
+		// only search paths we're supposed to...
+		if ( (pathtype != CF_TYPE_ANY) && (pathtype != f->pathtype_index) )
+			continue;
+
+		if (location_flags != CF_LOCATION_ALL) {
+			// If a location flag was specified we need to check if the root of this file satisfies the request
+			auto root = cf_get_root(f->root_index);
+
+			if (!cf_check_location_flags(root->location_flags, location_flags)) {
+				// Root does not satisfy location flags
+				continue;
+			}
+		}
+
+		return ui;
+	}
+
+	return Num_files;
 }
 
 /**
@@ -1132,80 +1444,44 @@ CFileLocation cf_find_file_location(const char* filespec, int pathtype, bool loc
 	}
 
 	// Search the pak files and CD-ROM.
-	for (ui = 0; ui < Num_files; ui++ )	{
-		cf_file *f = cf_get_file(ui);
-
-		// only search paths we're supposed to...
-		if ( (pathtype != CF_TYPE_ANY) && (pathtype != f->pathtype_index) )
-			continue;
-
-		if (location_flags != CF_LOCATION_ALL) {
-			// If a location flag was specified we need to check if the root of this file satisfies the request
-			auto root = cf_get_root(f->root_index);
-
-			if (!cf_check_location_flags(root->location_flags, location_flags)) {
-				// Root does not satisfy location flags
-				continue;
-			}
+	// The first file in the list which has either the localized or the plain name wins
+	ui = Num_files;
+	if (localize) {
+		// create localized filespec
+		strncpy(longname, filespec, MAX_PATH_LEN - 1);
+
+		if ( lcl_add_dir_to_path_with_filename(longname, MAX_PATH_LEN - 1) ) {
+			ui = cf_find_indexed_file(longname, pathtype, location_flags);
 		}
+	}
 
-		if (localize) {
-			// create localized filespec
-			strncpy(longname, filespec, MAX_PATH_LEN - 1);
+	// file either not localized or localized version not found
+	ui = MIN(ui, cf_find_indexed_file(filespec, pathtype, location_flags));
 
-			if ( lcl_add_dir_to_path_with_filename(longname, MAX_PATH_LEN - 1) ) {
-				if ( !stricmp(longname, f->name_ext) ) {
-					CFileLocation res(true);
-					res.size = static_cast<size_t>(f->size);
-					res.offset = (size_t)f->pack_offset;
-					res.data_ptr = f->data;
-					res.name_ext = f->name_ext;
-
-					if (f->data != nullptr) {
-						// This is an in-memory file so we just copy the pathtype name + file name
-						res.full_name = Pathtypes[f->pathtype_index].path;
-						res.full_name += DIR_SEPARATOR_STR;
-						res.full_name += f->name_ext;
-					} else if (f->pack_offset < 1) {
-						// This is a real file, return the actual file path
-						res.full_name = f->real_name;
-					} else {
-						// File is in a pack file
-						cf_root *r = cf_get_root(f->root_index);
-
-						res.full_name = r->path;
-					}
+	if (ui < Num_files) {
+		cf_file *f = cf_get_file(ui);
+		CFileLocation res(true);
+		res.size = static_cast<size_t>(f->size);
+		res.offset = (size_t)f->pack_offset;
+		res.data_ptr = f->data;
+		res.name_ext = f->name_ext;
+
+		if (f->data != nullptr) {
+			// This is an in-memory file so we just copy the pathtype name + file name
+			res.full_name = Pathtypes[f->pathtype_index].path;
+			res.full_name += DIR_SEPARATOR_STR;
+			res.full_name += f->name_ext;
+		} else if (f->pack_offset < 1) {
+			// This is a real file, return the actual file path
+			res.full_name = f->real_name;
+		} else {
+			// File is in a pack file
+			cf_root *r = cf_get_root(f->root_index);
 
-					return res;
-				}
-			}
+			res.full_name = r->path;
 		}
 
-		// file either not localized or localized version not found
-		if ( !stricmp(filespec, f->name_ext) ) {
-			CFileLocation res(true);
-			res.size = static_cast<size_t>(f->size);
-			res.offset = (size_t)f->pack_offset;
-			res.data_ptr = f->data;
-			res.name_ext = f->name_ext;
-
-			if (f->data != nullptr) {
-				// This is an in-memory file so we just copy the pathtype name + file name
-				res.full_name = Pathtypes[f->pathtype_index].path;
-				res.full_name += DIR_SEPARATOR_STR;
-				res.full_name += f->name_ext;
-			} else if (f->pack_offset < 1) {
-				// This is a real file, return the actual file path
-				res.full_name = f->real_name;
-			} else {
-				// File is in a pack file
-				cf_root *r = cf_get_root(f->root_index);
-
-				res.full_name = r->path;
-			}
-
-			return res;
-		}
+		return res;
 	}
 		
 	return CFileLocation();
@@ -487,6 +487,13 @@ cmdline_parm frame_profile_arg("-profile_frame_time", NULL, AT_NONE); //Cmdline_
 cmdline_parm debug_window_arg("-debug_window", NULL, AT_NONE);	// Cmdline_debug_window
 cmdline_parm graphics_debug_output_arg("-gr_debug", nullptr, AT_NONE); // Cmdline_graphics_debug_output
 cmdline_parm log_to_stdout_arg("-stdout_log", nullptr, AT_NONE); // Cmdline_log_to_stdout
+cmdline_parm bench_frames_arg("-bench_frames", "Number of frames simulated by fs2_bench", AT_INT); // Cmdline_bench_frames
+cmdline_parm bench_seed_arg("-bench_seed", "Random seed used by fs2_bench", AT_INT); // Cmdline_bench_seed
+cmdline_parm bench_output_arg("-bench_output", "File fs2_bench writes its timings to", AT_STRING); // Cmdline_bench_output
+cmdline_parm worker_threads_arg("-worker_threads", "Number of worker threads, 0 disables threading", AT_INT); // Cmdline_worker_threads
+cmdline_parm parallel_ai_arg("-parallel_ai", "Search for AI targets on the worker threads", AT_NONE); // Cmdline_parallel_ai
+cmdline_parm no_vp_manifest_arg("-no_vp_manifest", "Don't cache the file lists of VP files between runs", AT_NONE); // Cmdline_no_vp_manifest
+cmdline_parm cache_submodel_transforms_arg("-cache_submodel_transforms", "Cache the transforms of nested submodels, slightly changes their positions", AT_NONE); // Cmdline_cache_submodel_transforms
 
 
 char *Cmdline_start_mission = NULL;
@@ -519,6 +526,13 @@ bool Cmdline_show_video_info = false;
 bool Cmdline_debug_window = false;
 bool Cmdline_graphics_debug_output = false;
 bool Cmdline_log_to_stdout = false;
+int Cmdline_bench_frames = 3600;
+int Cmdline_bench_seed = 1;
+const char *Cmdline_bench_output = "fs2_bench.json";
+int Cmdline_worker_threads = -1;
+bool Cmdline_parallel_ai = false;
+bool Cmdline_no_vp_manifest = false;
+bool Cmdline_cache_submodel_transforms = false;
 
 // Other
 cmdline_parm get_flags_arg(GET_FLAGS_STRING, "Output the launcher flags file", AT_STRING);
@@ -2158,6 +2172,34 @@ bool SetCmdlineParams()
 		Cmdline_log_to_stdout = true;
 	}
 
+	if (bench_frames_arg.found()) {
+		Cmdline_bench_frames = bench_frames_arg.get_int();
+	}
+
+	if (bench_seed_arg.found()) {
+		Cmdline_bench_seed = bench_seed_arg.get_int();
+	}
+
+	if (bench_output_arg.found()) {
+		Cmdline_bench_output = bench_output_arg.str();
+	}
+
+	if (worker_threads_arg.found()) {
+		Cmdline_worker_threads = worker_threads_arg.get_int();
+	}
+
+	if (parallel_ai_arg.found()) {
+		Cmdline_parallel_ai = true;
+	}
+
+	if (no_vp_manifest_arg.found()) {
+		Cmdline_no_vp_manifest = true;
+	}
+
+	if (cache_submodel_transforms_arg.found()) {
+		Cmdline_cache_submodel_transforms = true;
+	}
+
 	if (show_video_info.found())
 	{
 		Cmdline_show_video_info = true;
@@ -151,6 +151,13 @@ extern bool Cmdline_show_video_info;
 extern bool Cmdline_debug_window;
 extern bool Cmdline_graphics_debug_output;
 extern bool Cmdline_log_to_stdout;
+extern int Cmdline_bench_frames;
+extern int Cmdline_bench_seed;
+extern const char *Cmdline_bench_output;
+extern int Cmdline_worker_threads;
+extern bool Cmdline_parallel_ai;
+extern bool Cmdline_no_vp_manifest;
+extern bool Cmdline_cache_submodel_transforms;
 
 enum class WeaponSpewType { NONE = 0, STANDARD, ALL };
 extern WeaponSpewType Cmdline_spew_weapon_stats;
@@ -12,8 +12,10 @@
 
 #include "gamesnd.h"
 #include "gamesnd/gamesnd.h"
+#include "cfile/cfile.h"
 #include "localization/localize.h"
 #include "parse/parselo.h"
+#include "sound/audiostr.h"
 #include "sound/ds.h"
 #include "species_defs/species_defs.h"
 #include "tracing/tracing.h"
@@ -531,6 +533,43 @@ void parse_iface_sound_list(const char* tag, SCP_vector<interface_snd_id>& desti
 	}
 }
 
+/**
+ * Loads the sounds of either the preloaded or the other game sounds, the sound files are read ahead in batches on the
+ * worker threads
+ */
+static void gamesnd_load_sounds(bool preload, const char* busy_text)
+{
+	const size_t prefetch_batch = 64;
+
+	SCP_vector<std::pair<game_snd*, game_snd_entry*>> to_load;
+	for (auto& gs: Snds) {
+		if ( gs.preload == preload ) {
+			for (auto& entry : gs.sound_entries) {
+				if ( entry.filename[0] != 0 && strnicmp(entry.filename, NOX("none.wav"), 4) != 0 ) {
+					to_load.emplace_back(&gs, &entry);
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < to_load.size(); ++i) {
+		if (i % prefetch_batch == 0) {
+			cf_prefetch_clear();
+
+			SCP_vector<SCP_string> filenames;
+			for (size_t j = i; j < MIN(i + prefetch_batch, to_load.size()); ++j) {
+				filenames.emplace_back(to_load[j].second->filename);
+			}
+			cf_prefetch_files(filenames, CF_TYPE_ANY, NUM_AUDIO_EXT, audio_ext_list);
+		}
+
+		game_busy( busy_text );	// Animate loading cursor... does nothing if loading screen not active.
+		to_load[i].second->id = snd_load(to_load[i].second, &to_load[i].first->flags);
+	}
+
+	cf_prefetch_clear();
+}
+
 /**
  * Load in sounds that we expect will get played
  *
@@ -544,16 +583,7 @@ void gamesnd_preload_common_sounds()
 		return;
 
 	Assert( Snds.size() <= INT_MAX );
-	for (auto& gs: Snds) {
-		if ( gs.preload ) {
-			for (auto& entry : gs.sound_entries) {
-				if ( entry.filename[0] != 0 && strnicmp(entry.filename, NOX("none.wav"), 4) != 0 ) {
-					game_busy( NOX("** preloading common game sounds **") );	// Animate loading cursor... does nothing if loading screen not active.
-					entry.id = snd_load(&entry, &gs.flags);
-				}
-			}
-		}
-	}
+	gamesnd_load_sounds(true, NOX("** preloading common game sounds **"));
 }
 
 /**
@@ -565,16 +595,7 @@ void gamesnd_load_gameplay_sounds()
 		return;
 
 	Assert( Snds.size() <= INT_MAX );
-	for (auto& gs: Snds) {
-		if ( !gs.preload ) { // don't try to load anything that's already preloaded
-			for (auto& entry : gs.sound_entries) {
-				if (entry.filename[0] != 0 && strnicmp(entry.filename, NOX("none.wav"), 4) != 0) {
-					game_busy(NOX("** preloading gameplay sounds **"));        // Animate loading cursor... does nothing if loading screen not active.
-					entry.id = snd_load(&entry, &gs.flags);
-				}
-			}
-		}
-	}
+	gamesnd_load_sounds(false, NOX("** preloading gameplay sounds **")); // don't try to load anything that's already preloaded
 }
 
 /**
@@ -1639,7 +1639,6 @@ void game_process_cheats(int k)
 			return;
 
 		ship *shipp = &Ships[Objects[objnum].instance];
-		shipp->ship_name[0] = '\0';
 		shipp->display_name.clear();
 		shipp->orders_accepted = (1<<NUM_COMM_ORDER_ITEMS)-1;
 
@@ -1648,9 +1647,10 @@ void game_process_cheats(int k)
 		ship_idx = 1;
 		do {
 			sprintf(name, NOX("Volition Bravos %d"), ship_idx);
-			if ( (ship_name_lookup(name) == -1) && (ship_find_exited_ship_by_name(name) == -1) )
+			int found = ship_name_lookup(name);
+			if ( ((found == -1) || (found == SHIP_INDEX(shipp))) && (ship_find_exited_ship_by_name(name) == -1) )
 			{
-				strcpy_s(shipp->ship_name, name);
+				ship_rename(shipp, name);
 				break;
 			}
 
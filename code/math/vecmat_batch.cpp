@@ -0,0 +1,244 @@
+/*
+ * Batched versions of the vecmat routines.
+ *
+ * Where SSE is available four vectors are processed at once. They are loaded from the vec3d array as three registers
+ * and shuffled into one register per component, so the arithmetic is the same sequence of single precision
+ * operations the scalar routines do, just four lanes wide, apart from any FMA contraction the compiler does. The
+ * remaining vectors go through the scalar routines.
+ */
+
+#include "math/vecmat.h"
+#include "math/vecmat_batch.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define VM_BATCH_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+static_assert(sizeof(vec3d) == 3 * sizeof(float), "The batch routines require vec3d to be three packed floats!");
+
+#ifdef VM_BATCH_USE_SSE
+
+namespace {
+
+// The components of four vectors, one register per component
+struct vec3d_x4 {
+	__m128 x, y, z;
+};
+
+// Loads src[0] to src[3]
+inline vec3d_x4 vm_batch_load(const vec3d *src)
+{
+	const float *in = src->a1d;
+
+	// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+	__m128 a = _mm_loadu_ps(in);
+	__m128 b = _mm_loadu_ps(in + 4);
+	__m128 c = _mm_loadu_ps(in + 8);
+
+	vec3d_x4 out;
+
+	__m128 x23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+	out.x = _mm_shuffle_ps(a, x23, _MM_SHUFFLE(2, 0, 3, 0));
+
+	__m128 y01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+	__m128 y23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+	out.y = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));
+
+	__m128 z01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+	__m128 z23 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+	out.z = _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(2, 0, 2, 0));
+
+	return out;
+}
+
+// Stores v into dest[0] to dest[3]
+inline void vm_batch_store(vec3d *dest, const vec3d_x4 &v)
+{
+	float *out = dest->a1d;
+
+	__m128 x0y0 = _mm_shuffle_ps(v.x, v.y, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 z0x1 = _mm_shuffle_ps(v.z, v.x, _MM_SHUFFLE(1, 1, 0, 0));
+	_mm_storeu_ps(out, _mm_shuffle_ps(x0y0, z0x1, _MM_SHUFFLE(2, 0, 2, 0)));
+
+	__m128 y1z1 = _mm_shuffle_ps(v.y, v.z, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 x2y2 = _mm_shuffle_ps(v.x, v.y, _MM_SHUFFLE(2, 2, 2, 2));
+	_mm_storeu_ps(out + 4, _mm_shuffle_ps(y1z1, x2y2, _MM_SHUFFLE(2, 0, 2, 0)));
+
+	__m128 z2x3 = _mm_shuffle_ps(v.z, v.x, _MM_SHUFFLE(3, 3, 2, 2));
+	__m128 y3z3 = _mm_shuffle_ps(v.y, v.z, _MM_SHUFFLE(3, 3, 3, 3));
+	_mm_storeu_ps(out + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+inline vec3d_x4 vm_batch_splat(const vec3d *v)
+{
+	vec3d_x4 out;
+	out.x = _mm_set1_ps(v->xyz.x);
+	out.y = _mm_set1_ps(v->xyz.y);
+	out.z = _mm_set1_ps(v->xyz.z);
+	return out;
+}
+
+// Same evaluation order as vm_vec_dot
+inline __m128 vm_batch_dot(const vec3d_x4 &a, const vec3d_x4 &b)
+{
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+}
+
+inline vec3d_x4 vm_batch_sub(const vec3d_x4 &a, const vec3d_x4 &b)
+{
+	vec3d_x4 out;
+	out.x = _mm_sub_ps(a.x, b.x);
+	out.y = _mm_sub_ps(a.y, b.y);
+	out.z = _mm_sub_ps(a.z, b.z);
+	return out;
+}
+
+// Multiplies the rows of m with four vectors, which is what operator*(matrix, vec3d) does
+inline void vm_batch_matrix_x_vec(vec3d *dest, const vec3d *src, size_t count, const matrix &m)
+{
+	const vec3d_x4 rvec = vm_batch_splat(&m.vec.rvec);
+	const vec3d_x4 uvec = vm_batch_splat(&m.vec.uvec);
+	const vec3d_x4 fvec = vm_batch_splat(&m.vec.fvec);
+
+	for (size_t i = 0; i < count; i += 4) {
+		vec3d_x4 in = vm_batch_load(&src[i]);
+
+		vec3d_x4 out;
+		out.x = vm_batch_dot(in, rvec);
+		out.y = vm_batch_dot(in, uvec);
+		out.z = vm_batch_dot(in, fvec);
+
+		vm_batch_store(&dest[i], out);
+	}
+}
+
+}
+
+#endif
+
+void vm_vec_rotate_batch(vec3d *dest, const vec3d *src, size_t count, const matrix *m)
+{
+	size_t i = 0;
+
+#ifdef VM_BATCH_USE_SSE
+	i = count & ~(size_t)3;
+	vm_batch_matrix_x_vec(dest, src, i, *m);
+#endif
+
+	for (; i < count; ++i) {
+		vm_vec_rotate(&dest[i], &src[i], m);
+	}
+}
+
+void vm_vec_unrotate_batch(vec3d *dest, const vec3d *src, size_t count, const matrix *m)
+{
+	size_t i = 0;
+
+#ifdef VM_BATCH_USE_SSE
+	matrix mt;
+	vm_copy_transpose(&mt, m);
+
+	i = count & ~(size_t)3;
+	vm_batch_matrix_x_vec(dest, src, i, mt);
+#endif
+
+	for (; i < count; ++i) {
+		vm_vec_unrotate(&dest[i], &src[i], m);
+	}
+}
+
+void vm_vec_dot_batch(float *dest, const vec3d *vecs, size_t count, const vec3d *v)
+{
+	size_t i = 0;
+
+#ifdef VM_BATCH_USE_SSE
+	const vec3d_x4 other = vm_batch_splat(v);
+
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(&dest[i], vm_batch_dot(vm_batch_load(&vecs[i]), other));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		dest[i] = vm_vec_dot(&vecs[i], v);
+	}
+}
+
+void vm_vec_dist_batch(float *dest, const vec3d *points, size_t count, const vec3d *pos)
+{
+	size_t i = 0;
+
+#ifdef VM_BATCH_USE_SSE
+	const vec3d_x4 origin = vm_batch_splat(pos);
+
+	for (; i + 4 <= count; i += 4) {
+		vec3d_x4 diff = vm_batch_sub(vm_batch_load(&points[i]), origin);
+
+		// vm_vec_mag returns 0 for squared magnitudes <= 0, which the square root does as well
+		_mm_storeu_ps(&dest[i], _mm_sqrt_ps(vm_batch_dot(diff, diff)));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		dest[i] = vm_vec_dist(&points[i], pos);
+	}
+}
+
+void vm_vec_dist_squared_batch(float *dest, const vec3d *points, size_t count, const vec3d *pos)
+{
+	size_t i = 0;
+
+#ifdef VM_BATCH_USE_SSE
+	const vec3d_x4 origin = vm_batch_splat(pos);
+
+	for (; i + 4 <= count; i += 4) {
+		vec3d_x4 diff = vm_batch_sub(vm_batch_load(&points[i]), origin);
+
+		_mm_storeu_ps(&dest[i], vm_batch_dot(diff, diff));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		dest[i] = vm_vec_dist_squared(&points[i], pos);
+	}
+}
+
+void vm_vec_normalize_safe_batch(vec3d *vecs, size_t count, float *mags)
+{
+	size_t i = 0;
+
+#ifdef VM_BATCH_USE_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one  = _mm_set1_ps(1.0f);
+
+	for (; i + 4 <= count; i += 4) {
+		vec3d_x4 v = vm_batch_load(&vecs[i]);
+
+		__m128 mag = _mm_sqrt_ps(vm_batch_dot(v, v));
+		__m128 inv = _mm_div_ps(one, mag);
+
+		// null vectors become (1, 0, 0) with a magnitude of 1, NaNs go through the division like they do in the
+		// scalar version
+		__m128 null = _mm_cmple_ps(mag, zero);
+
+		v.x = _mm_or_ps(_mm_and_ps(null, one), _mm_andnot_ps(null, _mm_mul_ps(v.x, inv)));
+		v.y = _mm_andnot_ps(null, _mm_mul_ps(v.y, inv));
+		v.z = _mm_andnot_ps(null, _mm_mul_ps(v.z, inv));
+
+		vm_batch_store(&vecs[i], v);
+
+		if (mags != nullptr) {
+			_mm_storeu_ps(&mags[i], _mm_or_ps(_mm_and_ps(null, one), _mm_andnot_ps(null, mag)));
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		float mag = vm_vec_normalize_safe(&vecs[i]);
+
+		if (mags != nullptr) {
+			mags[i] = mag;
+		}
+	}
+}
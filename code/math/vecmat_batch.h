@@ -0,0 +1,37 @@
+/*
+ * Batched versions of the vecmat routines which are called for many vectors at once.
+ *
+ * They work on plain vec3d arrays, so they can be used on any array of vectors without
+ * converting it first. Every function does the same operations for each element as the single vector routine it is
+ * named after. The results may still differ in the last bits since the compiler is free to contract multiplies and
+ * adds into FMAs differently in the two versions, so callers which need bit identical results must stay with one.
+ */
+
+
+
+#ifndef _VECMAT_BATCH_H
+#define _VECMAT_BATCH_H
+
+#include "globalincs/pstypes.h"
+
+// The destination arrays may be the same as the source arrays, but they may not overlap them partially.
+
+// dest[i] = src[i] rotated through m, like vm_vec_rotate
+void vm_vec_rotate_batch(vec3d *dest, const vec3d *src, size_t count, const matrix *m);
+
+// dest[i] = src[i] rotated through the transpose of m, like vm_vec_unrotate
+void vm_vec_unrotate_batch(vec3d *dest, const vec3d *src, size_t count, const matrix *m);
+
+// dest[i] = vm_vec_dot(&vecs[i], v)
+void vm_vec_dot_batch(float *dest, const vec3d *vecs, size_t count, const vec3d *v);
+
+// dest[i] = vm_vec_dist(&points[i], pos)
+void vm_vec_dist_batch(float *dest, const vec3d *points, size_t count, const vec3d *pos);
+
+// dest[i] = vm_vec_dist_squared(&points[i], pos)
+void vm_vec_dist_squared_batch(float *dest, const vec3d *points, size_t count, const vec3d *pos);
+
+// Normalizes every vector like vm_vec_normalize_safe. If mags is not null the magnitudes it returns are stored there.
+void vm_vec_normalize_safe_batch(vec3d *vecs, size_t count, float *mags = nullptr);
+
+#endif
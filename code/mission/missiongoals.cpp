@@ -391,6 +391,7 @@ void mission_init_goals()
 		Mission_events[i].event_log_argument_buffer.clear();
 		Mission_events[i].backup_log_buffer.clear();
 		Mission_events[i].previous_result = 0;
+		Mission_events[i].dormant_until = -1;
 	}
 
 	Mission_goal_timestamp = timestamp(GOAL_TIMESTAMP);
@@ -893,6 +894,30 @@ void mission_event_set_completion_sound_timestamp()
 	Mission_directive_sound_timestamp = timestamp(DIRECTIVE_SOUND_DELAY);
 }
 
+// Returns the mission time (in seconds) before which the formula can't become true, or -1 if the formula isn't gated by
+// the mission time.  Only conditions which consist of nothing but a has-time-elapsed with a constant time are
+// recognized, since evaluating those before the time has elapsed does nothing besides returning false.
+static int mission_event_time_gate(int formula)
+{
+	int cond = formula;
+
+	int op = get_operator_const(formula);
+	if ( (op == OP_WHEN) || (op == OP_EVERY_TIME) ) {
+		cond = CADR(formula);
+	}
+
+	if ( (cond < 0) || (get_operator_const(cond) != OP_HAS_TIME_ELAPSED) ) {
+		return -1;
+	}
+
+	int time_node = CDR(cond);
+	if ( (time_node < 0) || (CAR(time_node) != -1) || (Sexp_nodes[time_node].type & SEXP_FLAG_VARIABLE) || (Sexp_nodes[time_node].flags & SNF_SPECIAL_ARG_IN_NODE) ) {
+		return -1;
+	}
+
+	return atoi(Sexp_nodes[time_node].text);
+}
+
 // function which evaluates and processes the given event
 void mission_process_event( int event )
 {
@@ -982,6 +1007,17 @@ void mission_process_event( int event )
 	Event_index = -1;
 	Mission_events[event].result = result;
 
+	// A non-repeating event which just evaluated to false while its time gate is closed will evaluate the same way,
+	// with the same effects, until the gate opens, so there is no need to evaluate it again before then.  Events whose
+	// evaluation is logged are always evaluated.
+	Mission_events[event].dormant_until = -1;
+	if ( (sindex >= 0) && !result && !timestamp_valid(Mission_events[event].timestamp) && (Mission_events[event].mission_log_flags == 0) ) {
+		int gate = mission_event_time_gate(sindex);
+		if (f2i(Missiontime) < gate) {
+			Mission_events[event].dormant_until = gate;
+		}
+	}
+
 	// if the sexpression is known false, then no need to evaluate anymore
 	if ((sindex >= 0) && (Sexp_nodes[sindex].value == SEXP_KNOWN_FALSE)) {
 		Mission_events[event].timestamp = (int) Missiontime;
@@ -1112,6 +1148,11 @@ void mission_eval_goals()
 			// we will evaluate repeatable events at the top of the file so we can get
 			// the exact interval that the designer asked for.
 			if ( !timestamp_valid( Mission_events[i].timestamp) ){
+				// skip events which can't change yet
+				if ( (f2i(Missiontime) < Mission_events[i].dormant_until) && !Snapshot_all_events ) {
+					continue;
+				}
+
 				TRACE_SCOPE(tracing::NonrepeatingEvents);
 				mission_process_event( i );
 			}
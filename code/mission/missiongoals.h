@@ -124,6 +124,8 @@ typedef struct mission_event {
 	SCP_vector<SCP_string> backup_log_buffer;
 	int	previous_result;		// result of previous evaluation of event
 
+	int	dormant_until;			// mission time (in seconds) before which the event can't change, see mission_eval_goals()
+
 } mission_event;
 
 extern int Num_mission_events;
@@ -100,6 +100,18 @@ struct submodel_instance
 	matrix	canonical_orient = vmd_identity_matrix;
 	matrix	canonical_prev_orient = vmd_identity_matrix;
 
+	// Bumped by submodel_instance_orient_changed() whenever canonical_orient is written, so that the cached model
+	// transforms of this submodel and its children know that they are out of date
+	uint	orient_generation = 0;
+
+	// The transform from this submodel's frame of reference into the model's, including all parent submodels. Built on
+	// demand with -cache_submodel_transforms, see model_instance_find_world_point().
+	mutable matrix	model_orient = vmd_identity_matrix;
+	mutable vec3d	model_offset = vmd_zero_vector;
+	mutable uint	model_transform_stamp = 0;				// unique per build, 0 if never built
+	mutable uint	model_transform_generation = 0;			// orient_generation this was built from
+	mutable uint	model_transform_parent_stamp = 0;		// model_transform_stamp of the parent this was built from
+
 	// --- these fields used to be in bsp_info ---
 
 	// Electrical Arc Effect Info
@@ -930,6 +942,9 @@ extern void submodel_canonicalize(bsp_info *sm, submodel_instance *smi, bool cla
 extern void submodel_rotate(model_subsystem *psub, submodel_instance *smi);
 extern void submodel_rotate(bsp_info *sm, submodel_instance *smi);
 
+// Has to be called after canonical_orient of a submodel instance has been written, so that cached transforms get rebuilt
+inline void submodel_instance_orient_changed(submodel_instance *smi) { ++smi->orient_generation; }
+
 // Rotates the angle of a submodel.  Use this so the right unlocked axis
 // gets stuffed.  Does this for stepped rotations
 void submodel_stepped_rotate(model_subsystem *psub, submodel_instance *smi);
@@ -1150,8 +1165,25 @@ inline void mc_info_init(mc_info *mc)
 */
 
 int model_collide(mc_info *mc_info_obj);
+
+// The maximum number of rays model_collide_batch() checks together
+#define MC_BATCH_MAX	64
+
+// Checks several rays against the same model at once. This gives the same results as calling
+// model_collide() for each of them but walks the BSP trees only once for all rays.
+// Only segment checks against the whole model (MC_CHECK_MODEL, optionally with
+// MC_CHECK_INVISIBLE_FACES) of the same model instance, orientation, position and lod are
+// batched, everything else is passed on to model_collide().
+void model_collide_batch(mc_info **mc_info_list, int count);
+
 void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int version);
 
+// Replaces the nodes of a parsed collision tree with a SAH bounding volume hierarchy over its polygons
+void model_collide_build_bvh(bsp_collision_tree *tree);
+// Creates the collision trees of all submodels that collide, either by parsing their BSP data and building bounding
+// volume hierarchies over it or by loading the finished trees from the cache
+void model_create_collision_trees(polymodel *pm);
+
 bsp_collision_tree *model_get_bsp_collision_tree(int tree_index);
 void model_remove_bsp_collision_tree(int tree_index);
 int model_create_bsp_collision_tree();
@@ -538,6 +538,7 @@ void model_anim_submodel_trigger_rotate(model_subsystem *psub, ship_subsys *ss)
 		angs.b += PI2;
 
 	vm_angles_2_matrix(&smi->canonical_orient, &angs);
+	submodel_instance_orient_changed(smi);
 }
 
 //************************************//
@@ -602,6 +603,7 @@ bool model_anim_start_type(ship_subsys *pss, AnimationTriggerType animation_type
 				angles angs;
 				trigger->apply_trigger_angles(&angs);
 				vm_angles_2_matrix(&pss->submodel_instance_1->canonical_orient, &angs);
+				submodel_instance_orient_changed(pss->submodel_instance_1);
 
 				retval = true;
 			}
@@ -333,6 +333,7 @@ namespace animation {
 			return;
 
 		submodel->canonical_orient = data.orientation;
+		submodel_instance_orient_changed(submodel);
 
 		//TODO: Once translation is a thing
 		//m_subsys->submodel_instance_1->offset = data.position;
@@ -447,6 +448,7 @@ namespace animation {
 			return;
 
 		submodel->canonical_orient = data.orientation;
+		submodel_instance_orient_changed(submodel);
 
 		float angle;
 		vec3d axis;
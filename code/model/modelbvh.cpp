@@ -0,0 +1,774 @@
+/*
+ * Bounding volume hierarchies for the model collision trees.
+ *
+ * The collision trees parsed from the POF BSP data follow the splits the model converter picked, which are often far
+ * from optimal for ray queries. After parsing, the nodes of every collision tree are replaced by a binned SAH
+ * (surface area heuristic) BVH built over the polygons of the submodel. The BVH reuses the node and leaf structures of
+ * the parsed tree so the collision code does not need to know which kind of tree it is traversing: back and front are
+ * the two children of an inner node and leaf nodes point to a chain of polygons linked through the next member.
+ *
+ * Parsing the BSP data and building the hierarchies for large models takes a noticeable amount of time, so the finished
+ * collision trees are cached in the cache directory, keyed by a hash of the BSP data of the model. Loading a model
+ * whose trees are in the cache is then a read of the node, polygon and vertex arrays, which are checked against the
+ * model before they are used.
+ */
+
+#include <algorithm>
+#include <cfloat>
+
+#define MODEL_LIB
+
+#include "cfile/cfile.h"
+#include "graphics/tmapper.h"
+#include "math/vecmat.h"
+#include "model/model.h"
+#include "model/modelsinc.h"
+#include "tracing/tracing.h"
+
+#include <md5.h>
+
+namespace {
+
+// Bump this whenever the BSP parser, the builder or the cache file layout changes so that old cache files are ignored
+const int BVH_CACHE_VERSION = 3;
+const char BVH_CACHE_MAGIC[4] = { 'B', 'V', 'H', 'C' };
+
+// Nodes with at most this many polygons are turned into leaves if splitting them is not cheaper
+const int BVH_MAX_LEAF_POLYS = 4;
+const int BVH_NUM_BINS = 16;
+
+// The cost of traversing a node relative to testing a polygon
+const float BVH_TRAVERSAL_COST = 1.0f;
+
+// The node layout used by the builder and the cache files. The polygons of a leaf node are stored contiguously so the
+// polygon chains of the collision tree can be recreated (and validated) from the polygon order alone.
+struct bvh_node {
+	vec3d min;
+	vec3d max;
+
+	int back;
+	int front;
+
+	int first_poly;
+	int num_polys;
+};
+
+struct bvh_poly {
+	vec3d min;
+	vec3d max;
+	vec3d center;
+
+	int leaf;
+};
+
+struct bvh_bin {
+	vec3d min;
+	vec3d max;
+	int count;
+};
+
+// Written in front of the arrays of every collision tree in the cache file
+struct bvh_cache_tree {
+	int has_tree;
+	int n_nodes;
+	int n_leaves;
+	int n_verts;
+	int n_tmap_verts;
+};
+
+// The cache file stores every member on its own in little endian order, these are the sizes of the array elements
+const int BVH_CACHE_NODE_SIZE      = 6 * sizeof(float) + 3 * sizeof(int);
+const int BVH_CACHE_LEAF_SIZE      = 7 * sizeof(float) + 2 * sizeof(int) + 2 * sizeof(ubyte);
+const int BVH_CACHE_POINT_SIZE     = 3 * sizeof(float);
+const int BVH_CACHE_TMAP_VERT_SIZE = 2 * sizeof(ushort) + 2 * sizeof(float);
+
+// A collision tree read from a cache file
+struct bvh_cached_tree {
+	bvh_cache_tree counts;
+	SCP_vector<bsp_collision_node> nodes;
+	SCP_vector<bsp_collision_leaf> leaves;
+	SCP_vector<vec3d> points;
+	SCP_vector<model_tmap_vert> tmap_verts;
+};
+
+void bvh_bounds_clear(vec3d* min, vec3d* max)
+{
+	min->xyz.x = min->xyz.y = min->xyz.z = FLT_MAX;
+	max->xyz.x = max->xyz.y = max->xyz.z = -FLT_MAX;
+}
+
+void bvh_bounds_add(vec3d* min, vec3d* max, const vec3d* pmin, const vec3d* pmax)
+{
+	for (int i = 0; i < 3; ++i) {
+		min->a1d[i] = MIN(min->a1d[i], pmin->a1d[i]);
+		max->a1d[i] = MAX(max->a1d[i], pmax->a1d[i]);
+	}
+}
+
+// Half the surface area of a box, the factor does not matter for comparing costs
+float bvh_half_area(const vec3d* min, const vec3d* max)
+{
+	if (min->xyz.x > max->xyz.x) {
+		return 0.0f;
+	}
+
+	float dx = max->xyz.x - min->xyz.x;
+	float dy = max->xyz.y - min->xyz.y;
+	float dz = max->xyz.z - min->xyz.z;
+
+	return dx * dy + dy * dz + dz * dx;
+}
+
+class bvh_builder {
+  public:
+	explicit bvh_builder(const bsp_collision_tree* tree)
+	{
+		_polys.reserve(tree->n_leaves);
+
+		for (int i = 0; i < tree->n_leaves; ++i) {
+			auto leaf = &tree->leaf_list[i];
+
+			bvh_poly poly;
+			poly.leaf = i;
+
+			if (leaf->num_verts == 0) {
+				poly.min = leaf->plane_pnt;
+				poly.max = leaf->plane_pnt;
+			} else {
+				bvh_bounds_clear(&poly.min, &poly.max);
+
+				for (int j = 0; j < leaf->num_verts; ++j) {
+					auto point = &tree->point_list[tree->vert_list[leaf->vert_start + j].vertnum];
+					bvh_bounds_add(&poly.min, &poly.max, point, point);
+				}
+			}
+
+			vm_vec_avg(&poly.center, &poly.min, &poly.max);
+
+			_polys.push_back(poly);
+		}
+	}
+
+	void build(SCP_vector<bvh_node>& nodes, SCP_vector<int>& order)
+	{
+		_nodes.clear();
+		_nodes.reserve(_polys.size() * 2 / BVH_MAX_LEAF_POLYS + 1);
+
+		build_node(0, _polys.size());
+
+		order.clear();
+		order.reserve(_polys.size());
+		for (auto& poly : _polys) {
+			order.push_back(poly.leaf);
+		}
+
+		nodes.swap(_nodes);
+	}
+
+  private:
+	SCP_vector<bvh_poly> _polys;
+	SCP_vector<bvh_node> _nodes;
+
+	int build_node(size_t begin, size_t end)
+	{
+		int node_index = (int)_nodes.size();
+		_nodes.emplace_back();
+
+		vec3d min, max, center_min, center_max;
+		bvh_bounds_clear(&min, &max);
+		bvh_bounds_clear(&center_min, &center_max);
+
+		for (size_t i = begin; i < end; ++i) {
+			bvh_bounds_add(&min, &max, &_polys[i].min, &_polys[i].max);
+			bvh_bounds_add(&center_min, &center_max, &_polys[i].center, &_polys[i].center);
+		}
+
+		_nodes[node_index].min = min;
+		_nodes[node_index].max = max;
+
+		auto count = end - begin;
+
+		// Split along the axis where the polygon centers are spread out the most
+		int axis = 0;
+		for (int i = 1; i < 3; ++i) {
+			if (center_max.a1d[i] - center_min.a1d[i] > center_max.a1d[axis] - center_min.a1d[axis]) {
+				axis = i;
+			}
+		}
+		float extent = center_max.a1d[axis] - center_min.a1d[axis];
+
+		if (count <= 1 || (count <= BVH_MAX_LEAF_POLYS && extent <= 0.0f)) {
+			make_leaf(node_index, begin, end);
+			return node_index;
+		}
+
+		size_t mid = begin;
+
+		if (extent > 0.0f) {
+			bvh_bin bins[BVH_NUM_BINS];
+			for (auto& bin : bins) {
+				bvh_bounds_clear(&bin.min, &bin.max);
+				bin.count = 0;
+			}
+
+			float scale = BVH_NUM_BINS / extent;
+			auto bin_index = [&](const bvh_poly& poly) {
+				int index = (int)((poly.center.a1d[axis] - center_min.a1d[axis]) * scale);
+				return MIN(MAX(index, 0), BVH_NUM_BINS - 1);
+			};
+
+			for (size_t i = begin; i < end; ++i) {
+				auto& bin = bins[bin_index(_polys[i])];
+				bvh_bounds_add(&bin.min, &bin.max, &_polys[i].min, &_polys[i].max);
+				++bin.count;
+			}
+
+			// Sweep from the right to get the cost of the right side of every split plane
+			float right_cost[BVH_NUM_BINS];
+			vec3d right_min, right_max;
+			bvh_bounds_clear(&right_min, &right_max);
+			int right_count = 0;
+			for (int i = BVH_NUM_BINS - 1; i > 0; --i) {
+				bvh_bounds_add(&right_min, &right_max, &bins[i].min, &bins[i].max);
+				right_count += bins[i].count;
+				right_cost[i] = bvh_half_area(&right_min, &right_max) * right_count;
+			}
+
+			vec3d left_min, left_max;
+			bvh_bounds_clear(&left_min, &left_max);
+			int left_count = 0;
+			int best_split = -1;
+			float best_cost = FLT_MAX;
+			for (int i = 1; i < BVH_NUM_BINS; ++i) {
+				bvh_bounds_add(&left_min, &left_max, &bins[i - 1].min, &bins[i - 1].max);
+				left_count += bins[i - 1].count;
+
+				if (left_count == 0 || left_count == (int)count) {
+					continue;
+				}
+
+				float cost = bvh_half_area(&left_min, &left_max) * left_count + right_cost[i];
+				if (cost < best_cost) {
+					best_cost = cost;
+					best_split = i;
+				}
+			}
+
+			float area = bvh_half_area(&min, &max);
+			float leaf_cost = area * count;
+			float split_cost = area * BVH_TRAVERSAL_COST + best_cost;
+
+			if (count <= BVH_MAX_LEAF_POLYS && (best_split < 0 || split_cost >= leaf_cost)) {
+				make_leaf(node_index, begin, end);
+				return node_index;
+			}
+
+			if (best_split >= 0) {
+				auto split = std::partition(_polys.begin() + begin, _polys.begin() + end,
+				                            [&](const bvh_poly& poly) { return bin_index(poly) < best_split; });
+				mid = (size_t)(split - _polys.begin());
+			}
+		}
+
+		if (mid == begin || mid == end) {
+			// All polygons ended up on one side, fall back to a median split
+			mid = begin + count / 2;
+			std::nth_element(_polys.begin() + begin, _polys.begin() + mid, _polys.begin() + end,
+			                 [axis](const bvh_poly& a, const bvh_poly& b) {
+				                 return a.center.a1d[axis] < b.center.a1d[axis];
+			                 });
+		}
+
+		// Children are always created after their parent which the cache loader relies on
+		int back  = build_node(begin, mid);
+		int front = build_node(mid, end);
+
+		_nodes[node_index].back       = back;
+		_nodes[node_index].front      = front;
+		_nodes[node_index].first_poly = -1;
+		_nodes[node_index].num_polys  = 0;
+
+		return node_index;
+	}
+
+	void make_leaf(int node_index, size_t begin, size_t end)
+	{
+		auto& node      = _nodes[node_index];
+		node.back       = -1;
+		node.front      = -1;
+		node.first_poly = (int)begin;
+		node.num_polys  = (int)(end - begin);
+	}
+};
+
+// Checks if the hierarchy fits the collision tree. This can only fail for a corrupted cache file.
+bool bvh_validate(const bsp_collision_tree* tree, const SCP_vector<bvh_node>& nodes, const SCP_vector<int>& order)
+{
+	if (nodes.empty() || (int)order.size() != tree->n_leaves) {
+		return false;
+	}
+
+	SCP_vector<bool> seen(order.size(), false);
+	for (auto leaf : order) {
+		if (leaf < 0 || leaf >= tree->n_leaves || seen[leaf]) {
+			return false;
+		}
+		seen[leaf] = true;
+	}
+
+	auto n_nodes = (int)nodes.size();
+	for (int i = 0; i < n_nodes; ++i) {
+		auto& node = nodes[i];
+
+		if (node.num_polys > 0) {
+			if (node.first_poly < 0 || node.num_polys > tree->n_leaves - node.first_poly) {
+				return false;
+			}
+		} else if (node.back <= i || node.back >= n_nodes || node.front <= i || node.front >= n_nodes) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Replaces the nodes and leaves of the collision tree with the hierarchy
+void bvh_apply(bsp_collision_tree* tree, const SCP_vector<bvh_node>& nodes, const SCP_vector<int>& order)
+{
+	Assertion(bvh_validate(tree, nodes, order), "BVH does not match its collision tree!");
+
+	auto n_nodes   = (int)nodes.size();
+	auto leaf_list = (bsp_collision_leaf*)vm_malloc(sizeof(bsp_collision_leaf) * tree->n_leaves);
+	auto node_list = (bsp_collision_node*)vm_malloc(sizeof(bsp_collision_node) * n_nodes);
+
+	for (int i = 0; i < tree->n_leaves; ++i) {
+		leaf_list[i]      = tree->leaf_list[order[i]];
+		leaf_list[i].next = -1;
+	}
+
+	for (int i = 0; i < n_nodes; ++i) {
+		auto& node = nodes[i];
+
+		node_list[i].min = node.min;
+		node_list[i].max = node.max;
+
+		if (node.num_polys > 0) {
+			node_list[i].back  = -1;
+			node_list[i].front = -1;
+			node_list[i].leaf  = node.first_poly;
+
+			for (int j = node.first_poly; j < node.first_poly + node.num_polys - 1; ++j) {
+				leaf_list[j].next = j + 1;
+			}
+		} else {
+			node_list[i].back  = node.back;
+			node_list[i].front = node.front;
+			node_list[i].leaf  = -1;
+		}
+	}
+
+	vm_free(tree->leaf_list);
+	vm_free(tree->node_list);
+
+	tree->leaf_list = leaf_list;
+	tree->node_list = node_list;
+	tree->n_nodes   = n_nodes;
+}
+
+bool bvh_tree_usable(const bsp_collision_tree* tree)
+{
+	return tree->n_leaves > 0 && tree->n_verts > 0 && tree->node_list != nullptr;
+}
+
+// Returns the collision tree of the submodel if it should get a BVH
+bsp_collision_tree* bvh_get_tree(polymodel* pm, int submodel_num)
+{
+	if (pm->submodel[submodel_num].collision_tree_index < 0) {
+		return nullptr;
+	}
+
+	auto tree = model_get_bsp_collision_tree(pm->submodel[submodel_num].collision_tree_index);
+
+	return bvh_tree_usable(tree) ? tree : nullptr;
+}
+
+bool bvh_submodel_collides(const polymodel* pm, int submodel_num)
+{
+	return !(pm->submodel[submodel_num].nocollide_this_only || pm->submodel[submodel_num].no_collisions);
+}
+
+// The collision trees do not store the length of their polygon vertex list, every polygon has its own range in it
+int bvh_num_tmap_verts(const bsp_collision_tree* tree)
+{
+	int n_tmap_verts = 0;
+	for (int i = 0; i < tree->n_leaves; ++i) {
+		n_tmap_verts = MAX(n_tmap_verts, tree->leaf_list[i].vert_start + tree->leaf_list[i].num_verts);
+	}
+
+	return n_tmap_verts;
+}
+
+SCP_string bvh_cache_filename(polymodel* pm)
+{
+	MD5 md5;
+	md5.update(reinterpret_cast<const char*>(&BVH_CACHE_VERSION), sizeof(BVH_CACHE_VERSION));
+	// The BSP parser handles some chunks differently depending on the POF version
+	md5.update(reinterpret_cast<const char*>(&pm->version), sizeof(pm->version));
+
+	for (int i = 0; i < pm->n_models; ++i) {
+		auto sm = &pm->submodel[i];
+
+		// Include which submodels have collision trees since that changes the layout of the cache file
+		int has_tree = bvh_submodel_collides(pm, i) ? 1 : 0;
+		md5.update(reinterpret_cast<const char*>(&has_tree), sizeof(has_tree));
+		md5.update(reinterpret_cast<const char*>(&sm->bsp_data_size), sizeof(sm->bsp_data_size));
+		if (sm->bsp_data != nullptr && sm->bsp_data_size > 0) {
+			md5.update(reinterpret_cast<const char*>(sm->bsp_data), (MD5::size_type)sm->bsp_data_size);
+		}
+	}
+
+	md5.finalize();
+
+	return SCP_string("model_bvh-") + md5.hexdigest() + ".bin";
+}
+
+// Checks that the file still holds count elements of the given size
+bool bvh_cache_check_size(CFILE* fp, int count, int element_size)
+{
+	auto remaining = cfilelength(fp) - cftell(fp);
+
+	return count >= 0 && remaining >= 0 && (size_t)count <= (size_t)remaining / element_size;
+}
+
+void bvh_cache_read_vector(CFILE* fp, vec3d* v)
+{
+	v->xyz.x = cfread_float(fp);
+	v->xyz.y = cfread_float(fp);
+	v->xyz.z = cfread_float(fp);
+}
+
+void bvh_cache_write_vector(CFILE* fp, const vec3d* v)
+{
+	cfwrite_float(v->xyz.x, fp);
+	cfwrite_float(v->xyz.y, fp);
+	cfwrite_float(v->xyz.z, fp);
+}
+
+// The point list of a submodel as the BSP parser sees it
+void bvh_defpoints_counts(const polymodel* pm, int submodel_num, int* n_verts, int* n_norms)
+{
+	auto sm = &pm->submodel[submodel_num];
+
+	*n_verts = 0;
+	*n_norms = 0;
+
+	if (sm->bsp_data != nullptr && sm->bsp_data_size >= 20 && w(sm->bsp_data) == OP_DEFPOINTS) {
+		*n_verts = MAX(w(sm->bsp_data + 8), 0);
+		*n_norms = MAX(w(sm->bsp_data + 12), 0);
+	}
+}
+
+// Checks that the tree is one the BSP parser or the builder could have made for the submodel, so that the collision
+// code can traverse it without any further checks. This can only fail for a corrupted, foreign or stale cache file.
+bool bvh_cache_validate(const polymodel* pm, int submodel_num, const bvh_cached_tree& tree)
+{
+	auto& counts = tree.counts;
+
+	int n_verts, n_norms;
+	bvh_defpoints_counts(pm, submodel_num, &n_verts, &n_norms);
+
+	if (counts.n_verts != n_verts) {
+		return false;
+	}
+
+	// Children always come after their parent and polygon chains always go forward, which rules out cycles and keeps
+	// the recursion of model_collide_bsp() and the chains of model_collide_bsp_poly() bounded
+	for (int i = 0; i < counts.n_nodes; ++i) {
+		auto& node = tree.nodes[i];
+
+		if (node.leaf >= 0) {
+			if (node.leaf >= counts.n_leaves) {
+				return false;
+			}
+		} else if (node.leaf != -1) {
+			return false;
+		}
+
+		if ((node.back != -1 && (node.back <= i || node.back >= counts.n_nodes))
+		    || (node.front != -1 && (node.front <= i || node.front >= counts.n_nodes))) {
+			return false;
+		}
+	}
+
+	for (int i = 0; i < counts.n_leaves; ++i) {
+		auto& leaf = tree.leaves[i];
+
+		if (leaf.next != -1 && (leaf.next <= i || leaf.next >= counts.n_leaves)) {
+			return false;
+		}
+
+		if (leaf.num_verts > TMAP_MAX_VERTS || leaf.vert_start < 0
+		    || leaf.vert_start > counts.n_tmap_verts - leaf.num_verts) {
+			return false;
+		}
+	}
+
+	// Flat polygons use normal 0 even if the point list has no normals
+	for (auto& vert : tree.tmap_verts) {
+		if (vert.vertnum >= counts.n_verts || vert.normnum >= MAX(n_norms, 1)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool bvh_cache_read_tree(CFILE* fp, bvh_cached_tree& tree)
+{
+	if (!bvh_cache_check_size(fp, 5, sizeof(int))) {
+		return false;
+	}
+
+	auto& counts = tree.counts;
+
+	counts.has_tree     = cfread_int(fp);
+	counts.n_nodes      = cfread_int(fp);
+	counts.n_leaves     = cfread_int(fp);
+	counts.n_verts      = cfread_int(fp);
+	counts.n_tmap_verts = cfread_int(fp);
+
+	if (!counts.has_tree) {
+		return true;
+	}
+
+	if (!bvh_cache_check_size(fp, counts.n_nodes, BVH_CACHE_NODE_SIZE)) {
+		return false;
+	}
+
+	tree.nodes.resize(counts.n_nodes);
+	for (auto& node : tree.nodes) {
+		bvh_cache_read_vector(fp, &node.min);
+		bvh_cache_read_vector(fp, &node.max);
+		node.back  = cfread_int(fp);
+		node.front = cfread_int(fp);
+		node.leaf  = cfread_int(fp);
+	}
+
+	if (!bvh_cache_check_size(fp, counts.n_leaves, BVH_CACHE_LEAF_SIZE)) {
+		return false;
+	}
+
+	tree.leaves.resize(counts.n_leaves);
+	for (auto& leaf : tree.leaves) {
+		bvh_cache_read_vector(fp, &leaf.plane_pnt);
+		bvh_cache_read_vector(fp, &leaf.plane_norm);
+		leaf.face_rad   = cfread_float(fp);
+		leaf.vert_start = cfread_int(fp);
+		leaf.num_verts  = cfread_ubyte(fp);
+		leaf.tmap_num   = cfread_ubyte(fp);
+		leaf.next       = cfread_int(fp);
+	}
+
+	if (!bvh_cache_check_size(fp, counts.n_verts, BVH_CACHE_POINT_SIZE)) {
+		return false;
+	}
+
+	tree.points.resize(counts.n_verts);
+	for (auto& point : tree.points) {
+		bvh_cache_read_vector(fp, &point);
+	}
+
+	if (!bvh_cache_check_size(fp, counts.n_tmap_verts, BVH_CACHE_TMAP_VERT_SIZE)) {
+		return false;
+	}
+
+	tree.tmap_verts.resize(counts.n_tmap_verts);
+	for (auto& vert : tree.tmap_verts) {
+		vert.vertnum = cfread_ushort(fp);
+		vert.normnum = cfread_ushort(fp);
+		vert.u       = cfread_float(fp);
+		vert.v       = cfread_float(fp);
+	}
+
+	return true;
+}
+
+template <typename T>
+T* bvh_cache_copy_array(const SCP_vector<T>& array)
+{
+	if (array.empty()) {
+		return nullptr;
+	}
+
+	auto copy = (T*)vm_malloc(sizeof(T) * array.size());
+	memcpy(copy, array.data(), sizeof(T) * array.size());
+
+	return copy;
+}
+
+bool bvh_cache_load(polymodel* pm, const SCP_string& filename)
+{
+	auto fp = cfopen(filename.c_str(), "rb", CFILE_NORMAL, CF_TYPE_CACHE, false,
+	                 CF_LOCATION_ROOT_USER | CF_LOCATION_ROOT_GAME | CF_LOCATION_TYPE_ROOT);
+	if (!fp) {
+		return false;
+	}
+
+	char magic[sizeof(BVH_CACHE_MAGIC)];
+	if (cfread(magic, sizeof(magic), 1, fp) != 1 || memcmp(magic, BVH_CACHE_MAGIC, sizeof(magic)) != 0
+	    || !bvh_cache_check_size(fp, 2, sizeof(int)) || cfread_int(fp) != BVH_CACHE_VERSION
+	    || cfread_int(fp) != pm->n_models) {
+		cfclose(fp);
+		return false;
+	}
+
+	// Read and check everything first so that a bad file does not leave the model half loaded
+	SCP_vector<bvh_cached_tree> trees(pm->n_models);
+
+	for (int i = 0; i < pm->n_models; ++i) {
+		if (!bvh_cache_read_tree(fp, trees[i]) || (trees[i].counts.has_tree != 0) != bvh_submodel_collides(pm, i)
+		    || (trees[i].counts.has_tree && !bvh_cache_validate(pm, i, trees[i]))) {
+			mprintf(("BVH cache file %s for model %s is corrupt, rebuilding.\n", filename.c_str(), pm->filename));
+			cfclose(fp);
+			return false;
+		}
+	}
+
+	cfclose(fp);
+
+	for (int i = 0; i < pm->n_models; ++i) {
+		auto& cached = trees[i];
+		if (!cached.counts.has_tree) {
+			continue;
+		}
+
+		pm->submodel[i].collision_tree_index = model_create_bsp_collision_tree();
+		auto tree = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
+
+		tree->n_nodes    = cached.counts.n_nodes;
+		tree->node_list  = bvh_cache_copy_array(cached.nodes);
+		tree->n_leaves   = cached.counts.n_leaves;
+		tree->leaf_list  = bvh_cache_copy_array(cached.leaves);
+		tree->n_verts    = cached.counts.n_verts;
+		tree->point_list = bvh_cache_copy_array(cached.points);
+		tree->vert_list  = bvh_cache_copy_array(cached.tmap_verts);
+	}
+
+	return true;
+}
+
+void bvh_cache_save(polymodel* pm, const SCP_string& filename)
+{
+	auto fp = cfopen(filename.c_str(), "wb", CFILE_NORMAL, CF_TYPE_CACHE, false,
+	                 CF_LOCATION_ROOT_USER | CF_LOCATION_ROOT_GAME | CF_LOCATION_TYPE_ROOT);
+	if (!fp) {
+		nprintf(("ModelBVH", "Could not open BVH cache file %s for writing.\n", filename.c_str()));
+		return;
+	}
+
+	cfwrite(BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC), 1, fp);
+	cfwrite_int(BVH_CACHE_VERSION, fp);
+	cfwrite_int(pm->n_models, fp);
+
+	for (int i = 0; i < pm->n_models; ++i) {
+		bsp_collision_tree* tree = nullptr;
+		if (pm->submodel[i].collision_tree_index >= 0) {
+			tree = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
+		}
+
+		auto n_tmap_verts = tree != nullptr ? bvh_num_tmap_verts(tree) : 0;
+
+		cfwrite_int(tree != nullptr ? 1 : 0, fp);
+		cfwrite_int(tree != nullptr ? tree->n_nodes : 0, fp);
+		cfwrite_int(tree != nullptr ? tree->n_leaves : 0, fp);
+		cfwrite_int(tree != nullptr ? tree->n_verts : 0, fp);
+		cfwrite_int(n_tmap_verts, fp);
+
+		if (tree == nullptr) {
+			continue;
+		}
+
+		for (int j = 0; j < tree->n_nodes; ++j) {
+			auto& node = tree->node_list[j];
+			bvh_cache_write_vector(fp, &node.min);
+			bvh_cache_write_vector(fp, &node.max);
+			cfwrite_int(node.back, fp);
+			cfwrite_int(node.front, fp);
+			cfwrite_int(node.leaf, fp);
+		}
+
+		for (int j = 0; j < tree->n_leaves; ++j) {
+			auto& leaf = tree->leaf_list[j];
+			bvh_cache_write_vector(fp, &leaf.plane_pnt);
+			bvh_cache_write_vector(fp, &leaf.plane_norm);
+			cfwrite_float(leaf.face_rad, fp);
+			cfwrite_int(leaf.vert_start, fp);
+			cfwrite_ubyte(leaf.num_verts, fp);
+			cfwrite_ubyte(leaf.tmap_num, fp);
+			cfwrite_int(leaf.next, fp);
+		}
+
+		for (int j = 0; j < tree->n_verts; ++j) {
+			bvh_cache_write_vector(fp, &tree->point_list[j]);
+		}
+
+		for (int j = 0; j < n_tmap_verts; ++j) {
+			auto& vert = tree->vert_list[j];
+			cfwrite_ushort(vert.vertnum, fp);
+			cfwrite_ushort(vert.normnum, fp);
+			cfwrite_float(vert.u, fp);
+			cfwrite_float(vert.v, fp);
+		}
+	}
+
+	cfclose(fp);
+}
+
+} // namespace
+
+void model_collide_build_bvh(bsp_collision_tree* tree)
+{
+	if (!bvh_tree_usable(tree)) {
+		return;
+	}
+
+	SCP_vector<bvh_node> nodes;
+	SCP_vector<int> order;
+
+	bvh_builder(tree).build(nodes, order);
+	bvh_apply(tree, nodes, order);
+}
+
+void model_create_collision_trees(polymodel* pm)
+{
+	auto filename = bvh_cache_filename(pm);
+
+	if (bvh_cache_load(pm, filename)) {
+		return;
+	}
+
+	{
+		TRACE_SCOPE(tracing::ModelParseAllBSPTrees);
+
+		for (int i = 0; i < pm->n_models; ++i) {
+			if (bvh_submodel_collides(pm, i)) {
+				pm->submodel[i].collision_tree_index = model_create_bsp_collision_tree();
+				auto tree = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
+				model_collide_parse_bsp(tree, pm->submodel[i].bsp_data, pm->version);
+			}
+		}
+	}
+
+	{
+		TRACE_SCOPE(tracing::ModelCreateBVHTrees);
+
+		for (int i = 0; i < pm->n_models; ++i) {
+			auto tree = bvh_get_tree(pm, i);
+			if (tree != nullptr) {
+				model_collide_build_bvh(tree);
+			}
+		}
+	}
+
+	bvh_cache_save(pm, filename);
+}
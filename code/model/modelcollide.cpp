@@ -21,6 +21,11 @@
 #include "tracing/tracing.h"
 #include "tracing/Monitor.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MC_BATCH_USE_SSE
+#include <xmmintrin.h>
+#endif
+
 
 
 #define TOL		1E-4
@@ -28,27 +33,28 @@
 
 // Some global variables that get set by model_collide and are used internally for
 // checking a collision rather than passing a bunch of parameters around. These are
-// not persistant between calls to model_collide
+// not persistant between calls to model_collide. They are thread local so that
+// model_collide can be called from the worker threads.
 
-static mc_info		*Mc;				// The mc_info passed into model_collide
+static thread_local mc_info		*Mc;				// The mc_info passed into model_collide
 	
-static polymodel	*Mc_pm;			// The polygon model we're checking
-static int			Mc_submodel;	// The current submodel we're checking
+static thread_local polymodel	*Mc_pm;			// The polygon model we're checking
+static thread_local int			Mc_submodel;	// The current submodel we're checking
 
-static polymodel_instance *Mc_pmi;
+static thread_local polymodel_instance *Mc_pmi;
 
-static matrix		Mc_orient;		// A matrix to rotate a world point into the current
+static thread_local matrix		Mc_orient;		// A matrix to rotate a world point into the current
 											// submodel's frame of reference.
-static vec3d		Mc_base;			// A point used along with Mc_orient.
+static thread_local vec3d		Mc_base;			// A point used along with Mc_orient.
 
-static vec3d		Mc_p0;			// The ray origin rotated into the current submodel's frame of reference
-static vec3d		Mc_p1;			// The ray end rotated into the current submodel's frame of reference
-static float		Mc_mag;			// The length of the ray
-static vec3d		Mc_direction;	// A vector from the ray's origin to its end, in the current submodel's frame of reference
+static thread_local vec3d		Mc_p0;			// The ray origin rotated into the current submodel's frame of reference
+static thread_local vec3d		Mc_p1;			// The ray end rotated into the current submodel's frame of reference
+static thread_local float		Mc_mag;			// The length of the ray
+static thread_local vec3d		Mc_direction;	// A vector from the ray's origin to its end, in the current submodel's frame of reference
 
 static vec3d 		**Mc_point_list = NULL;		// A pointer to the current submodel's vertex list
 
-static float		Mc_edge_time;
+static thread_local float		Mc_edge_time;
 
 
 void model_collide_free_point_list()
@@ -588,8 +594,11 @@ void model_collide_bsp_poly(bsp_collision_tree *tree, int leaf_index)
 			if ( (!(Mc->flags & MC_CHECK_INVISIBLE_FACES)) && (Mc_pm->maps[leaf->tmap_num].textures[TM_BASE_TYPE].GetTexture() < 0) )	{
 				// Don't check invisible polygons.
 				//SUSHI: Unless $collide_invisible is set.
-				if (!(Mc_pm->submodel[Mc_submodel].collide_invisible))
-					return;
+				// Only skip this polygon, the other polygons of a leaf may use a different texture
+				if (!(Mc_pm->submodel[Mc_submodel].collide_invisible)) {
+					tested_leaf = leaf->next;
+					continue;
+				}
 			}
 		} else {
 			flat_poly = true;
@@ -1332,3 +1341,372 @@ int model_collide(mc_info *mc_info_obj)
 
 	return Mc->num_hits;
 }
+
+//=========================== BATCHED RAY CHECKS ================================
+//
+// model_collide_batch() walks the submodel hierarchy and the BSP trees once for a whole packet of rays. The bounding
+// boxes of the BSP nodes are first tested against four rays at a time with a conservative test which only rejects
+// rays that clearly miss. The rays that pass get the same exact test model_collide() uses and the polygons are checked
+// by the regular code so the results are identical to checking every ray on its own.
+
+// The rays of the current batch in the frame of reference of the submodel which is currently checked
+struct mc_batch_rays {
+	mc_info *mc[MC_BATCH_MAX];
+	vec3d p0[MC_BATCH_MAX];
+	vec3d p1[MC_BATCH_MAX];
+	vec3d dir[MC_BATCH_MAX];
+	vec3d inv_dir[MC_BATCH_MAX];
+	float mag[MC_BATCH_MAX];
+};
+
+static thread_local mc_batch_rays Mc_batch;
+
+// Bounding boxes are grown by this fraction of their size for the conservative test
+#define MC_BATCH_BOX_TOLERANCE	1E-4f
+// Rays are kept if they enter the bounding box before this fraction of their length
+#define MC_BATCH_MAX_T			1.01f
+
+// Makes one ray of the batch the ray the scalar collision code works on
+static void mc_batch_select_ray(int ray)
+{
+	Mc = Mc_batch.mc[ray];
+	Mc_p0 = Mc_batch.p0[ray];
+	Mc_p1 = Mc_batch.p1[ray];
+	Mc_direction = Mc_batch.dir[ray];
+	Mc_mag = Mc_batch.mag[ray];
+}
+
+static float mc_batch_safe_inverse(float value)
+{
+	// Keep the inverse finite so the slab test never has to deal with infinities times zero
+	const float min_value = 1E-20f;
+
+	if (value >= 0.0f) {
+		return 1.0f / std::max(value, min_value);
+	} else {
+		return 1.0f / std::min(value, -min_value);
+	}
+}
+
+// Transforms the rays into the frame of reference of the current submodel
+static void mc_batch_transform_ray(int ray)
+{
+	vec3d tempv;
+	mc_info *mc = Mc_batch.mc[ray];
+
+	vm_vec_sub(&tempv, mc->p0, &Mc_base);
+	vm_vec_rotate(&Mc_batch.p0[ray], &tempv, &Mc_orient);
+
+	vm_vec_sub(&tempv, mc->p1, &Mc_base);
+	vm_vec_rotate(&Mc_batch.p1[ray], &tempv, &Mc_orient);
+	vm_vec_sub(&Mc_batch.dir[ray], &Mc_batch.p1[ray], &Mc_batch.p0[ray]);
+
+	for (int axis = 0; axis < 3; ++axis) {
+		Mc_batch.inv_dir[ray].a1d[axis] = mc_batch_safe_inverse(Mc_batch.dir[ray].a1d[axis]);
+	}
+}
+
+/**
+ * Removes the rays which can't hit a bounding box
+ *
+ * This is a conservative test, the rays it keeps still need the exact test.
+ * @return The number of rays written to rays_out
+ */
+static int mc_batch_cull_box(const vec3d *min, const vec3d *max, const int *rays, int num_rays, int *rays_out)
+{
+	float box_min[3], box_max[3];
+	for (int axis = 0; axis < 3; ++axis) {
+		float tolerance = MC_BATCH_BOX_TOLERANCE * (1.0f + std::max(fl_abs(min->a1d[axis]), fl_abs(max->a1d[axis])));
+
+		box_min[axis] = min->a1d[axis] - tolerance;
+		box_max[axis] = max->a1d[axis] + tolerance;
+	}
+
+	int num_out = 0;
+
+#ifdef MC_BATCH_USE_SSE
+	int i = 0;
+	for (; i + 4 <= num_rays; i += 4) {
+		const int r0 = rays[i], r1 = rays[i + 1], r2 = rays[i + 2], r3 = rays[i + 3];
+
+		__m128 t_near = _mm_setzero_ps();
+		__m128 t_far = _mm_set1_ps(MC_BATCH_MAX_T);
+
+		for (int axis = 0; axis < 3; ++axis) {
+			__m128 p0 = _mm_setr_ps(Mc_batch.p0[r0].a1d[axis], Mc_batch.p0[r1].a1d[axis], Mc_batch.p0[r2].a1d[axis], Mc_batch.p0[r3].a1d[axis]);
+			__m128 inv = _mm_setr_ps(Mc_batch.inv_dir[r0].a1d[axis], Mc_batch.inv_dir[r1].a1d[axis], Mc_batch.inv_dir[r2].a1d[axis], Mc_batch.inv_dir[r3].a1d[axis]);
+
+			__m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box_min[axis]), p0), inv);
+			__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box_max[axis]), p0), inv);
+
+			t_near = _mm_max_ps(t_near, _mm_min_ps(t0, t1));
+			t_far = _mm_min_ps(t_far, _mm_max_ps(t0, t1));
+		}
+
+		int mask = _mm_movemask_ps(_mm_cmple_ps(t_near, t_far));
+
+		if (mask & 1) rays_out[num_out++] = r0;
+		if (mask & 2) rays_out[num_out++] = r1;
+		if (mask & 4) rays_out[num_out++] = r2;
+		if (mask & 8) rays_out[num_out++] = r3;
+	}
+#else
+	int i = 0;
+#endif
+
+	for (; i < num_rays; ++i) {
+		const int ray = rays[i];
+
+		float t_near = 0.0f;
+		float t_far = MC_BATCH_MAX_T;
+
+		for (int axis = 0; axis < 3; ++axis) {
+			float t0 = (box_min[axis] - Mc_batch.p0[ray].a1d[axis]) * Mc_batch.inv_dir[ray].a1d[axis];
+			float t1 = (box_max[axis] - Mc_batch.p0[ray].a1d[axis]) * Mc_batch.inv_dir[ray].a1d[axis];
+
+			t_near = std::max(t_near, std::min(t0, t1));
+			t_far = std::min(t_far, std::max(t0, t1));
+		}
+
+		if (t_near <= t_far) {
+			rays_out[num_out++] = ray;
+		}
+	}
+
+	return num_out;
+}
+
+// The batched version of model_collide_bsp()
+static void mc_batch_collide_bsp(bsp_collision_tree *tree, int node_index, const int *rays, int num_rays)
+{
+	bsp_collision_node *node = &tree->node_list[node_index];
+
+	int hit_rays[MC_BATCH_MAX];
+	int num_candidates = mc_batch_cull_box(&node->min, &node->max, rays, num_rays, hit_rays);
+
+	// Do the same exact check model_collide_bsp() does for the rays which passed
+	int num_hit = 0;
+	for (int i = 0; i < num_candidates; ++i) {
+		const int ray = hit_rays[i];
+		vec3d hitpos;
+
+		if ( fvi_ray_boundingbox(&node->min, &node->max, &Mc_batch.p0[ray], &Mc_batch.dir[ray], &hitpos) ) {
+			if ( vm_vec_dist(&hitpos, &Mc_batch.p0[ray]) <= Mc_batch.mag[ray] ) {
+				hit_rays[num_hit++] = ray;
+			}
+		}
+	}
+
+	if (num_hit == 0) {
+		return;
+	}
+
+	if ( node->leaf >= 0 ) {
+		for (int i = 0; i < num_hit; ++i) {
+			mc_batch_select_ray(hit_rays[i]);
+			model_collide_bsp_poly(tree, node->leaf);
+		}
+	} else {
+		if ( node->back >= 0 ) mc_batch_collide_bsp(tree, node->back, hit_rays, num_hit);
+		if ( node->front >= 0 ) mc_batch_collide_bsp(tree, node->front, hit_rays, num_hit);
+	}
+}
+
+// The batched version of mc_check_subobj()
+static void mc_batch_check_subobj(int mn, int lod, const int *rays, int num_rays)
+{
+	Assert( mn >= 0 );
+	Assert( mn < Mc_pm->n_models );
+	if ( (mn < 0) || (mn>=Mc_pm->n_models) ) return;
+
+	bsp_info *sm = &Mc_pm->submodel[mn];
+	if (sm->no_collisions) return; // don't do collisions
+
+	int active_rays[MC_BATCH_MAX];
+	int num_active = 0;
+
+	if (sm->nocollide_this_only) {
+		// Don't collide for this model, but keep checking others
+		std::copy(rays, rays + num_rays, active_rays);
+		num_active = num_rays;
+	} else {
+		int box_rays[MC_BATCH_MAX];
+		int num_box = 0;
+
+		for (int i = 0; i < num_rays; ++i) {
+			const int ray = rays[i];
+			vec3d hitpt;
+
+			mc_batch_transform_ray(ray);
+
+			// bail early if no ray exists
+			if ( IS_VEC_NULL(&Mc_batch.dir[ray]) ) {
+				continue;
+			}
+
+			// Quickly bail if we aren't inside the full model bbox
+			if ( Mc_pm->detail[0] == mn && !fvi_ray_boundingbox(&Mc_pm->mins, &Mc_pm->maxs, &Mc_batch.p0[ray], &Mc_batch.dir[ray], &hitpt) ) {
+				continue;
+			}
+
+			active_rays[num_active++] = ray;
+
+			// Check if the ray intersects this subobject's bounding box
+			if ( fvi_ray_boundingbox(&sm->min, &sm->max, &Mc_batch.p0[ray], &Mc_batch.dir[ray], &hitpt) ) {
+				box_rays[num_box++] = ray;
+			}
+		}
+
+		Mc_submodel = mn;
+
+		if (num_box > 0) {
+			bsp_info *lod_sm = sm;
+
+			if (lod > 0 && sm->num_details > 0) {
+				for (int i = lod - 1; i >= 0; i--) {
+					if (sm->details[i] != -1) {
+						lod_sm = &Mc_pm->submodel[sm->details[i]];
+						break;
+					}
+				}
+			}
+
+			auto tree = model_get_bsp_collision_tree(lod_sm->collision_tree_index);
+			if ( tree->node_list != nullptr && tree->n_verts > 0 ) {
+				mc_batch_collide_bsp(tree, 0, box_rays, num_box);
+			}
+		}
+	}
+
+	// If this subobject doesn't have any children, we're done checking it.
+	if ( sm->num_children < 1 || num_active == 0 ) return;
+
+	// Save instance (Mc_orient, Mc_base, Mc_point_base)
+	matrix saved_orient = Mc_orient;
+	vec3d saved_base = Mc_base;
+
+	// Check all of this subobject's children
+	int i = sm->first_child;
+	while ( i >= 0 )	{
+		matrix instance_orient;
+		bool blown_off;
+		bool collision_checked;
+		bsp_info * csm = &Mc_pm->submodel[i];
+
+		if ( Mc_pmi ) {
+			instance_orient = Mc_pmi->submodel[i].canonical_orient;
+			blown_off = Mc_pmi->submodel[i].blown_off;
+			collision_checked = Mc_pmi->submodel[i].collision_checked;
+		} else {
+			instance_orient = vmd_identity_matrix;
+			blown_off = false;
+			collision_checked = false;
+		}
+
+		// Don't check it or its children if it is destroyed
+		// or if it's set to no collision
+		if ( !blown_off && !collision_checked && !csm->no_collisions )	{
+			vm_vec_unrotate(&Mc_base, &csm->offset, &saved_orient);
+			vm_vec_add2(&Mc_base, &saved_base);
+
+			vm_matrix_x_matrix(&Mc_orient, &saved_orient, &instance_orient);
+
+			mc_batch_check_subobj( i, lod, active_rays, num_active );
+		}
+
+		i = csm->next_sibling;
+	}
+}
+
+static bool mc_batch_compatible(const mc_info *first, const mc_info *mc)
+{
+	return (mc->flags & ~MC_CHECK_INVISIBLE_FACES) == MC_CHECK_MODEL
+		&& mc->model_num == first->model_num
+		&& mc->model_instance_num == first->model_instance_num
+		&& mc->orient == first->orient
+		&& mc->pos == first->pos
+		&& mc->lod == first->lod;
+}
+
+// Checks up to MC_BATCH_MAX compatible rays
+static void mc_batch_collide(mc_info **mc_info_list, int count)
+{
+	Assert( count <= MC_BATCH_MAX );
+
+	mc_info *first = mc_info_list[0];
+
+	Mc_pm = model_get(first->model_num);
+	Mc_pmi = (first->model_instance_num >= 0) ? model_get_instance(first->model_instance_num) : nullptr;
+	Mc_edge_time = FLT_MAX;
+
+	int rays[MC_BATCH_MAX];
+	int num_rays = 0;
+
+	for (int i = 0; i < count; ++i) {
+		mc_info *mc = mc_info_list[i];
+
+		MONITOR_INC(NumFVI,1);
+
+		mc->num_hits = 0;
+		mc->shield_hit_tri = -1;
+		mc->hit_bitmap = -1;
+		mc->edge_hit = 0;
+
+		// Do a quick check on the Bounding Sphere
+		if ( fvi_segment_sphere(&mc->hit_point_world, mc->p0, mc->p1, mc->pos, Mc_pm->rad) ) {
+			Mc_batch.mc[i] = mc;
+			Mc_batch.mag[i] = vm_vec_dist(mc->p0, mc->p1);
+			rays[num_rays++] = i;
+		}
+	}
+
+	if ( num_rays == 0 ) {
+		return;
+	}
+
+	Mc_orient = *first->orient;
+	Mc_base = *first->pos;
+
+	// Don't check it or its children if it is destroyed
+	if ( !Mc_pmi || !Mc_pmi->submodel[Mc_pm->detail[0]].blown_off ) {
+		mc_batch_check_subobj(Mc_pm->detail[0], first->lod, rays, num_rays);
+	}
+
+	//If we found a hit, then rotate it into world coordinates
+	for (int i = 0; i < num_rays; ++i) {
+		mc_info *mc = Mc_batch.mc[rays[i]];
+
+		if ( mc->num_hits ) {
+			if ( Mc_pmi ) {
+				model_instance_find_world_point(&mc->hit_point_world, &mc->hit_point, Mc_pm, Mc_pmi, mc->hit_submodel, mc->orient, mc->pos);
+			} else {
+				model_find_world_point(&mc->hit_point_world, &mc->hit_point, Mc_pm, mc->hit_submodel, mc->orient, mc->pos);
+			}
+		}
+	}
+}
+
+void model_collide_batch(mc_info **mc_info_list, int count)
+{
+	mc_info *batch[MC_BATCH_MAX];
+	int batch_size = 0;
+
+	for (int i = 0; i < count; ++i) {
+		mc_info *mc = mc_info_list[i];
+
+		if ( batch_size > 0 && (batch_size == MC_BATCH_MAX || !mc_batch_compatible(batch[0], mc)) ) {
+			mc_batch_collide(batch, batch_size);
+			batch_size = 0;
+		}
+
+		if ( (mc->flags & ~MC_CHECK_INVISIBLE_FACES) == MC_CHECK_MODEL ) {
+			batch[batch_size++] = mc;
+		} else {
+			model_collide(mc);
+		}
+	}
+
+	if ( batch_size > 0 ) {
+		mc_batch_collide(batch, batch_size);
+	}
+}
@@ -37,6 +37,7 @@
 #include "ship/ship.h"
 #include "weapon/weapon.h"
 #include "tracing/tracing.h"
+#include "utils/ThreadPool.h"
 
 #include <algorithm>
 
@@ -3054,15 +3055,7 @@ int model_load(const  char *filename, int n_subsystems, model_subsystem *subsyst
 
 	model_octant_create( pm );
 
-	TRACE_SCOPE(tracing::ModelParseAllBSPTrees);
-
-	for (i = 0; i < pm->n_models; ++i) {
-		if (!(pm->submodel[i].nocollide_this_only || pm->submodel[i].no_collisions)) {
-			pm->submodel[i].collision_tree_index = model_create_bsp_collision_tree();
-			bsp_collision_tree* tree             = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
-			model_collide_parse_bsp(tree, pm->submodel[i].bsp_data, pm->version);
-		}
-	}
+	model_create_collision_trees(pm);
 
 	// Find the core_radius... the minimum of 
 	float rx, ry, rz;
@@ -3638,6 +3631,8 @@ void submodel_canonicalize(bsp_info *sm, submodel_instance *smi, bool clamp)
 			vm_quaternion_rotate(&smi->canonical_orient, smi->cur_angle, &sm->movement_axis);
 			break;
 	}
+
+	submodel_instance_orient_changed(smi);
 }
 
 // Does stepped rotation of a submodel
@@ -3884,6 +3879,7 @@ int model_rotate_gun(object *objp, polymodel *pm, polymodel_instance *pmi, ship_
 		// Pretend the base is pointing directly at the target
 		save_base_orient = base_smi->canonical_orient;
 		vm_quaternion_rotate(&base_smi->canonical_orient, desired_base_angle, &base_sm->movement_axis);
+		submodel_instance_orient_changed(base_smi);
 
 		//------------
 		// Project the destination point onto the turret gun plane with the base in the desired orientation
@@ -3907,6 +3903,7 @@ int model_rotate_gun(object *objp, polymodel *pm, polymodel_instance *pmi, ship_
 		//------------
 		// Restore the base
 		base_smi->canonical_orient = save_base_orient;
+		submodel_instance_orient_changed(base_smi);
 
 	} else {
 		desired_base_angle = base_smi->turret_idle_angle;
@@ -4022,6 +4019,56 @@ void model_find_world_point(vec3d *outpnt, vec3d *mpnt, const polymodel *pm, int
 	vm_vec_add2(outpnt,objpos);
 }
 
+static uint Model_transform_next_stamp = 1;
+
+// Submodels attached straight to the model are transformed in a single step anyway, so the cached transforms are only
+// used for submodels nested deeper than that. Other threads may read the submodel instances during a parallel job, so
+// the cache is not touched then.
+static bool model_instance_use_cached_transform(const polymodel *pm, int submodel_num)
+{
+	return Cmdline_cache_submodel_transforms && submodel_num >= 0 && pm->submodel[submodel_num].parent >= 0
+		&& pm->submodel[pm->submodel[submodel_num].parent].parent >= 0 && !util::in_parallel_job();
+}
+
+// Returns the submodel instance with an up to date transform into the model's frame of reference, rebuilding the
+// transforms of the submodel and its parents if their orientation changed since they were built
+static const submodel_instance *model_instance_get_model_transform(const polymodel *pm, const polymodel_instance *pmi, int submodel_num)
+{
+	auto sm = &pm->submodel[submodel_num];
+	auto smi = &pmi->submodel[submodel_num];
+	Assert(sm->parent >= 0);
+
+	const submodel_instance *parent_smi = nullptr;
+	if (pm->submodel[sm->parent].parent >= 0) {
+		parent_smi = model_instance_get_model_transform(pm, pmi, sm->parent);
+	}
+	uint parent_stamp = (parent_smi != nullptr) ? parent_smi->model_transform_stamp : 0;
+
+	if (smi->model_transform_stamp != 0 && smi->model_transform_generation == smi->orient_generation
+		&& smi->model_transform_parent_stamp == parent_stamp) {
+		return smi;
+	}
+
+	if (parent_smi == nullptr) {
+		smi->model_orient = smi->canonical_orient;
+		smi->model_offset = sm->offset;
+	} else {
+		vec3d offset;
+		vm_matrix_x_matrix(&smi->model_orient, &parent_smi->model_orient, &smi->canonical_orient);
+		vm_vec_unrotate(&offset, &sm->offset, &parent_smi->model_orient);
+		vm_vec_add(&smi->model_offset, &offset, &parent_smi->model_offset);
+	}
+
+	smi->model_transform_stamp = Model_transform_next_stamp++;
+	if (Model_transform_next_stamp == 0) {
+		Model_transform_next_stamp = 1;
+	}
+	smi->model_transform_generation = smi->orient_generation;
+	smi->model_transform_parent_stamp = parent_stamp;
+
+	return smi;
+}
+
 void model_instance_find_world_point(vec3d *outpnt, vec3d *mpnt, int model_instance_num, int submodel_num, const matrix *objorient, const vec3d *objpos)
 {
 	auto pmi = model_get_instance(model_instance_num);
@@ -4039,6 +4086,13 @@ void model_instance_find_world_point(vec3d *outpnt, vec3d *mpnt, const polymodel
 	pnt = *mpnt;
 	mn = submodel_num;
 
+	if (model_instance_use_cached_transform(pm, mn)) {
+		auto smi = model_instance_get_model_transform(pm, pmi, mn);
+		vm_vec_unrotate(&tpnt, &pnt, &smi->model_orient);
+		vm_vec_add(&pnt, &tpnt, &smi->model_offset);
+		mn = -1;
+	}
+
 	//instance up the tree for this point
 	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
 		vm_vec_unrotate(&tpnt, &pnt, &pmi->submodel[mn].canonical_orient);
@@ -4358,6 +4412,12 @@ void model_instance_find_world_dir(vec3d *out_dir, const vec3d *in_dir, const po
 	pnt = *in_dir;
 	mn = submodel_num;
 
+	if (model_instance_use_cached_transform(pm, mn)) {
+		vm_vec_unrotate(&tpnt, &pnt, &model_instance_get_model_transform(pm, pmi, mn)->model_orient);
+		pnt = tpnt;
+		mn = -1;
+	}
+
 	// instance up the tree for this point
 	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
 		vm_vec_unrotate(&tpnt, &pnt, &pmi->submodel[mn].canonical_orient);
@@ -4465,6 +4525,7 @@ void model_update_instance(polymodel *pm, polymodel_instance *pmi, const submode
 				r_smi->canonical_orient = smi->canonical_orient;
 				r_smi->canonical_prev_orient = smi->canonical_prev_orient;
 			}
+			submodel_instance_orient_changed(r_smi);
 		}
 	} else {
 		// If submodel isn't yet blown off and has a -destroyed replacement model, we prevent
@@ -4480,6 +4541,7 @@ void model_update_instance(polymodel *pm, polymodel_instance *pmi, const submode
 		smi->cur_angle = copy_from->cur_angle;
 		smi->canonical_orient = copy_from->canonical_orient;
 		smi->canonical_prev_orient = copy_from->canonical_prev_orient;
+		submodel_instance_orient_changed(smi);
 	}
 
 	// For all the detail levels of this submodel, set them also.
@@ -4624,6 +4686,7 @@ void model_init_submodel_axis_pt(polymodel *pm, polymodel_instance *pmi, int sub
 	// reset submodel angs
 	smi->cur_angle = save_angle;
 	smi->canonical_orient = save_orient;
+	submodel_instance_orient_changed(smi);
 
 	// find direction vectors of the two lines
 	vm_vec_sub2(&v1, &p1);
@@ -15,6 +15,7 @@
 #include "network/multiutil.h"
 #include "network/multi_log.h"
 #include "object/object.h"
+#include "object/objectspatial.h"
 #include "ship/ship.h"
 #include "freespace.h"
 #include "io/key.h"
@@ -147,6 +148,7 @@ void multi_df_level_pre_enter()
 			Ships[Objects[Net_players[idx].m_player->objnum].instance].team = Iff_traitor;
 		}
 	}
+	obj_spatial_invalidate();
 
 	// 
 }
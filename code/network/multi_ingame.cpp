@@ -14,6 +14,7 @@
 
 #include "globalincs/globals.h"
 #include "object/object.h"
+#include "object/objectspatial.h"
 #include "ship/ship.h"
 #include "weapon/weapon.h"
 #include "network/multi.h"
@@ -1043,10 +1044,11 @@ void process_ingame_ships_packet( ubyte *data, header *hinfo )
 		multi_ship_record_add_ship(objnum);
 
 		// assign any common data
-		strcpy_s(Ships[ship_num].ship_name, ship_name);
+		ship_rename(&Ships[ship_num], ship_name);
 		Ships[ship_num].flags.from_u64(sflags);
 		Ships[ship_num].team = team;
 		Ships[ship_num].wingnum = (int)wing_data;				
+		obj_spatial_invalidate();
 
 		GET_DATA( p_type );
 	}
@@ -1233,6 +1235,7 @@ void process_ingame_wings_packet( ubyte *data, header *hinfo )
 			// now, recreate all the ships needed
 			for (i = 0; i < current_count; i++ ) {
 				int which_one, team, slot_index, specific_instance;
+				char bashed_name[NAME_LENGTH];
 				ship *shipp;
 				object *objp;
 
@@ -1259,7 +1262,8 @@ void process_ingame_wings_packet( ubyte *data, header *hinfo )
 				// kind of stupid, but bash the name since it won't get recreated properly from
 				// the parse_wing_create_ships call.
 				shipp = &Ships[shipnum];
-				wing_bash_ship_name(shipp->ship_name, wingp->name, which_one + 1);
+				wing_bash_ship_name(bashed_name, wingp->name, which_one + 1);
+				ship_rename(shipp, bashed_name);
 				nprintf(("Network", "Created %s\n", shipp->ship_name));
 
 				objp = &Objects[shipp->objnum];
@@ -1985,12 +1985,14 @@ int multi_oo_unpack_data(net_player* pl, ubyte* data, int seq_num)
 				if (flags[i] & OO_SUBSYS_ROTATION_1) {
 					vm_angles_2_matrix(&subsysp->submodel_instance_1->canonical_prev_orient, prev_angs_1);
 					vm_angles_2_matrix(&subsysp->submodel_instance_1->canonical_orient, angs_1);
+					submodel_instance_orient_changed(subsysp->submodel_instance_1);
 					delete prev_angs_1;
 					delete angs_1;
 				}
 				if (flags[i] & OO_SUBSYS_ROTATION_2) {
 					vm_angles_2_matrix(&subsysp->submodel_instance_2->canonical_prev_orient, prev_angs_2);
 					vm_angles_2_matrix(&subsysp->submodel_instance_2->canonical_orient, angs_2);
+					submodel_instance_orient_changed(subsysp->submodel_instance_2);
 					delete prev_angs_2;
 					delete angs_2;
 				}
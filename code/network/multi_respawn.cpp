@@ -13,6 +13,7 @@
 #include "network/multi_respawn.h"
 #include "network/multi.h"
 #include "object/object.h"
+#include "object/objectspatial.h"
 #include "globalincs/linklist.h"
 #include "network/multimsgs.h"
 #include "network/multiutil.h"
@@ -449,6 +450,7 @@ void multi_respawn_player(net_player *pl, char cur_primary_bank, char cur_second
 	// if this is a dogfight mission, make him TEAM_TRAITOR
 	if(Netgame.type_flags & NG_TYPE_DOGFIGHT){
 		shipp->team = Iff_traitor;
+		obj_spatial_invalidate();
 	}
 
 	// maybe bash ship position
@@ -1574,7 +1574,7 @@ void multi_create_standalone_object()
 	// make ship hidden from sensors so that this observer cannot target it.  Observers really have two ships
 	// one observer, and one "Player_ship".  Observer needs to ignore the Player_ship.
     Player_ship->flags.set(Ship::Ship_Flags::Hidden_from_sensors);
-	strcpy_s(Player_ship->ship_name, XSTR("Standalone Ship",904));
+	ship_rename(Player_ship, XSTR("Standalone Ship",904));
 	Player_ai = &Ai_info[Ships[Objects[pobj_num].instance].ai_index];		
 
 }
@@ -23,10 +23,14 @@
 #include "ship/ship.h"
 #include "ship/shipfx.h"
 #include "ship/shiphit.h"
+#include "tracing/tracing.h"
+#include "utils/ThreadPool.h"
 #include "weapon/weapon.h"
 
 
 extern float ai_endangered_time(object *ship_objp, object *weapon_objp);
+static bool ship_weapon_needs_big_ship_check( object *ship, object *weapon_obj );
+static float big_ship_check_limit_time( object *ship, object *weapon_obj, float *time_to_max_error = nullptr );
 static int check_inside_radius_for_big_ships( object *ship, object *weapon_obj, obj_pair *pair );
 extern float flFrametime;
 
@@ -141,51 +145,112 @@ static void ship_weapon_do_hit_stuff(object *pship_obj, object *weapon_obj, vec3
 
 extern int Framecount;
 
-static int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, float time_limit = 0.0f, int *next_hit = nullptr)
-{
-	mc_info mc, mc_shield, mc_hull;
-	ship	*shipp;
-	ship_info *sip;
-	weapon	*wp;
-	weapon_info	*wip;
+/**
+ * The geometric part of a ship-weapon collision check.
+ *
+ * This only reads game state so it can be evaluated on the worker threads ahead of the actual collision handling. The
+ * result may only be used if the inputs recorded here still match when the collision is handled, otherwise the test
+ * is evaluated again.
+ */
+struct ship_weapon_hit_test {
+	object *ship_objp = nullptr;
+	object *weapon_objp = nullptr;
+
+	// The inputs the result depends on
+	float time_limit = 0.0f;
+	vec3d ship_pos;
+	matrix ship_orient;
+	vec3d ship_vel;
+	vec3d weapon_pos;
+	vec3d weapon_last_pos;
+	vec3d weapon_vel;
+	vec3d weapon_fired_pos;
+
+	// The end points of the checked path, the mc_info structs point to these
+	vec3d weapon_start_pos;
+	vec3d weapon_end_pos;
+	vec3d shield_ignored_until;
 
-	Assert( ship_objp != nullptr );
-	Assert( ship_objp->type == OBJ_SHIP );
-	Assert( ship_objp->instance >= 0 );
+	mc_info mc_shield;
+	mc_info mc_hull;
+	int shield_collision = 0;
+	int hull_collision = 0;
 
-	shipp = &Ships[ship_objp->instance];
-	sip = &Ship_info[shipp->ship_info_index];
+	bool evaluated = false;
+	bool used = false;
+};
 
-	Assert( weapon_objp != nullptr );
-	Assert( weapon_objp->type == OBJ_WEAPON );
-	Assert( weapon_objp->instance >= 0 );
+// Storage for the hit tests done by collide_ship_weapon_evaluate_pairs()
+static SCP_vector<ship_weapon_hit_test> Ship_weapon_hit_tests;
+static SCP_vector<size_t> Ship_weapon_hit_test_order;
+static SCP_vector<std::pair<size_t, size_t>> Ship_weapon_hit_test_groups;
 
-	wp = &Weapons[weapon_objp->instance];
-	wip = &Weapon_info[wp->weapon_info_index];
+static void ship_weapon_hit_test_init(ship_weapon_hit_test *test, object *ship_objp, object *weapon_objp, float time_limit)
+{
+	test->ship_objp = ship_objp;
+	test->weapon_objp = weapon_objp;
+	test->time_limit = time_limit;
+	test->ship_pos = ship_objp->pos;
+	test->ship_orient = ship_objp->orient;
+	test->ship_vel = ship_objp->phys_info.vel;
+	test->weapon_pos = weapon_objp->pos;
+	test->weapon_last_pos = weapon_objp->last_pos;
+	test->weapon_vel = weapon_objp->phys_info.vel;
+	test->weapon_fired_pos = Weapons[weapon_objp->instance].start_pos;
+	test->shield_collision = 0;
+	test->hull_collision = 0;
+	test->evaluated = false;
+	test->used = false;
+}
 
+/**
+ * Checks if a hit test is still valid for the given objects. The comparison is exact so that using a precomputed
+ * result gives the same result as evaluating the test again.
+ */
+static bool ship_weapon_hit_test_matches(const ship_weapon_hit_test *test, object *ship_objp, object *weapon_objp, float time_limit)
+{
+	return test->evaluated
+		&& test->ship_objp == ship_objp
+		&& test->weapon_objp == weapon_objp
+		&& memcmp(&test->time_limit, &time_limit, sizeof(time_limit)) == 0
+		&& memcmp(&test->ship_pos, &ship_objp->pos, sizeof(vec3d)) == 0
+		&& memcmp(&test->ship_orient, &ship_objp->orient, sizeof(matrix)) == 0
+		&& memcmp(&test->ship_vel, &ship_objp->phys_info.vel, sizeof(vec3d)) == 0
+		&& memcmp(&test->weapon_pos, &weapon_objp->pos, sizeof(vec3d)) == 0
+		&& memcmp(&test->weapon_last_pos, &weapon_objp->last_pos, sizeof(vec3d)) == 0
+		&& memcmp(&test->weapon_vel, &weapon_objp->phys_info.vel, sizeof(vec3d)) == 0
+		&& memcmp(&test->weapon_fired_pos, &Weapons[weapon_objp->instance].start_pos, sizeof(vec3d)) == 0;
+}
 
-	Assert( shipp->objnum == OBJ_INDEX(ship_objp));
+/**
+ * Checks the path of the weapon against the shield of the ship. This is the first part of ship_weapon_evaluate_hit_test().
+ *
+ * @warning This may be called from a worker thread so it must not change anything outside of the hit test.
+ * @return true if mc_hull still needs to be checked with model_collide()
+ */
+static bool ship_weapon_hit_test_check_shield(ship_weapon_hit_test *test)
+{
+	object *ship_objp = test->ship_objp;
+	object *weapon_objp = test->weapon_objp;
+	ship *shipp = &Ships[ship_objp->instance];
+	ship_info *sip = &Ship_info[shipp->ship_info_index];
+	weapon *wp = &Weapons[weapon_objp->instance];
+	polymodel *pm = model_get(sip->model_num);
+	mc_info mc;
 
-	// Make ships that are warping in not get collision detection done
-	if ( shipp->is_arriving() ) return 0;
-	
-	//	Return information for AI to detect incoming fire.
-	//	Could perhaps be done elsewhere at lower cost --MK, 11/7/97
-	float	dist = vm_vec_dist_quick(&ship_objp->pos, &weapon_objp->pos);
-	if (dist < weapon_objp->phys_info.speed) {
-		update_danger_weapon(ship_objp, weapon_objp);
-	}
+	mc_info &mc_shield = test->mc_shield;
+	mc_info &mc_hull = test->mc_hull;
+	int &shield_collision = test->shield_collision;
+	int &hull_collision = test->hull_collision;
 
-	int	valid_hit_occurred = 0;				// If this is set, then hitpos is set
-	int	quadrant_num = -1;
-	polymodel *pm = model_get(sip->model_num);
+	vec3d &weapon_end_pos = test->weapon_end_pos;
+	vec3d &weapon_start_pos = test->weapon_start_pos;
 
 	//	total time is flFrametime + time_limit (time_limit used to predict collisions into the future)
-	vec3d weapon_end_pos;
-	vm_vec_scale_add( &weapon_end_pos, &weapon_objp->pos, &weapon_objp->phys_info.vel, time_limit );
+	vm_vec_scale_add( &weapon_end_pos, &weapon_objp->pos, &weapon_objp->phys_info.vel, test->time_limit );
 
 
-	vec3d weapon_start_pos = weapon_objp->last_pos;
+	weapon_start_pos = weapon_objp->last_pos;
 	// Maybe take into account the ship's velocity, so it won't later overstep the weapon's
 	// current position (what will be its last_pos next frame)
 	if (The_mission.ai_profile->flags[AI::Profile_Flags::Fixed_ship_weapon_collision])
@@ -225,15 +290,12 @@ static int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, f
 	// will absorb it when it hits the hull instead.  This has no fancy graphical effect, though.
 	// Someone should make one.
 
-	// check both kinds of collisions
-	int shield_collision = 0;
-	int hull_collision = 0;
-
 	// check shields for impact
 	if (!(ship_objp->flags[Object::Object_Flags::No_shields])) {
 		if (sip->flags[Ship::Info_Flags::Auto_spread_shields]) {
 			// The weapon is not allowed to impact the shield before it reaches this point
-			vec3d shield_ignored_until = weapon_objp->last_pos;
+			vec3d &shield_ignored_until = test->shield_ignored_until;
+			shield_ignored_until = weapon_objp->last_pos;
 
 			float weapon_flown_for = vm_vec_dist(&wp->start_pos, &weapon_objp->last_pos);
 			float min_weapon_span;
@@ -366,11 +428,25 @@ static int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, f
 		if (sip->auto_shield_spread_bypass) {
 			shield_collision = 0;
 		}
-	} else {
-		mc_hull.flags = MC_CHECK_MODEL;
-		hull_collision = model_collide(&mc_hull);
+
+		return false;
 	}
 
+	mc_hull.flags = MC_CHECK_MODEL;
+	return true;
+}
+
+/**
+ * Finishes a hit test after the hull has been checked
+ *
+ * @warning This may be called from a worker thread so it must not change anything outside of the hit test.
+ */
+static void ship_weapon_hit_test_finish(ship_weapon_hit_test *test)
+{
+	ship *shipp = &Ships[test->ship_objp->instance];
+	int &shield_collision = test->shield_collision;
+	int &hull_collision = test->hull_collision;
+
 	// check if the hit point is beyond the clip plane when warping out.
 	if (hull_collision || shield_collision) {
 		WarpEffect* warp_effect = nullptr;
@@ -383,8 +459,8 @@ static int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, f
 		bool hull_no_collide, shield_no_collide;
 		hull_no_collide = shield_no_collide = false;
 		if (warp_effect != nullptr) {
-			hull_no_collide = point_is_clipped_by_warp(&mc_hull.hit_point_world, warp_effect);
-			shield_no_collide = point_is_clipped_by_warp(&mc_shield.hit_point_world, warp_effect);
+			hull_no_collide = point_is_clipped_by_warp(&test->mc_hull.hit_point_world, warp_effect);
+			shield_no_collide = point_is_clipped_by_warp(&test->mc_shield.hit_point_world, warp_effect);
 		}
 
 		if (hull_no_collide)
@@ -393,6 +469,76 @@ static int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, f
 			shield_collision = 0;
 	}
 
+	test->evaluated = true;
+}
+
+/**
+ * Checks the path of the weapon against the shield and the hull of the ship.
+ *
+ * @warning This may be called from a worker thread so it must not change anything outside of the hit test.
+ */
+static void ship_weapon_evaluate_hit_test(ship_weapon_hit_test *test)
+{
+	if (ship_weapon_hit_test_check_shield(test)) {
+		test->hull_collision = model_collide(&test->mc_hull);
+	}
+
+	ship_weapon_hit_test_finish(test);
+}
+
+static int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, float time_limit = 0.0f, int *next_hit = nullptr, ship_weapon_hit_test *hit_test = nullptr)
+{
+	mc_info mc;
+	ship	*shipp;
+	ship_info *sip;
+	weapon	*wp;
+	weapon_info	*wip;
+
+	Assert( ship_objp != nullptr );
+	Assert( ship_objp->type == OBJ_SHIP );
+	Assert( ship_objp->instance >= 0 );
+
+	shipp = &Ships[ship_objp->instance];
+	sip = &Ship_info[shipp->ship_info_index];
+
+	Assert( weapon_objp != nullptr );
+	Assert( weapon_objp->type == OBJ_WEAPON );
+	Assert( weapon_objp->instance >= 0 );
+
+	wp = &Weapons[weapon_objp->instance];
+	wip = &Weapon_info[wp->weapon_info_index];
+
+
+	Assert( shipp->objnum == OBJ_INDEX(ship_objp));
+
+	// Make ships that are warping in not get collision detection done
+	if ( shipp->is_arriving() ) return 0;
+	
+	//	Return information for AI to detect incoming fire.
+	//	Could perhaps be done elsewhere at lower cost --MK, 11/7/97
+	float	dist = vm_vec_dist_quick(&ship_objp->pos, &weapon_objp->pos);
+	if (dist < weapon_objp->phys_info.speed) {
+		update_danger_weapon(ship_objp, weapon_objp);
+	}
+
+	int	valid_hit_occurred = 0;				// If this is set, then hitpos is set
+	int	quadrant_num = -1;
+
+	// Use the precomputed geometry if it's still valid
+	ship_weapon_hit_test local_test;
+	if (hit_test != nullptr && ship_weapon_hit_test_matches(hit_test, ship_objp, weapon_objp, time_limit)) {
+		hit_test->used = true;
+	} else {
+		ship_weapon_hit_test_init(&local_test, ship_objp, weapon_objp, time_limit);
+		ship_weapon_evaluate_hit_test(&local_test);
+		hit_test = &local_test;
+	}
+
+	mc_info &mc_shield = hit_test->mc_shield;
+	mc_info &mc_hull = hit_test->mc_hull;
+	int shield_collision = hit_test->shield_collision;
+	int hull_collision = hit_test->hull_collision;
+
 	if (shield_collision) {
 		// pick out the shield quadrant
 		quadrant_num = get_quadrant(&mc_shield.hit_point, ship_objp);
@@ -524,8 +670,6 @@ int collide_ship_weapon( obj_pair * pair )
 	Assert( ship->type == OBJ_SHIP );
 	Assert( weapon_obj->type == OBJ_WEAPON );
 
-	ship_info *sip = &Ship_info[Ships[ship->instance].ship_info_index];
-
 	// Cyborg17 - no ship-ship collisions when doing multiplayer rollback
 	if ( (Game_mode & GM_MULTIPLAYER) && multi_ship_record_get_rollback_wep_mode() && (weapon_obj->parent_sig == OBJ_INDEX(ship)) ) {
 		return 0;
@@ -544,18 +688,11 @@ int collide_ship_weapon( obj_pair * pair )
 	// If it does hit, don't check the pair until about 200 ms before collision.  
 	// If it does not hit and is within error tolerance, cull the pair.
 
-	if ( (sip->is_big_or_huge()) && (weapon_obj->phys_info.flags & PF_CONST_VEL) ) {
-		// Check when within ~1.1 radii.  
-		// This allows good transition between sphere checking (leaving the laser about 200 ms from radius) and checking
-		// within the sphere with little time between.  There may be some time for "small" big ships
-		// Note: culling ships with auto spread shields seems to waste more performance than it saves,
-		// so we're not doing that here
-		if ( !(sip->flags[Ship::Info_Flags::Auto_spread_shields]) && vm_vec_dist_squared(&ship->pos, &weapon_obj->pos) < (1.2f*ship->radius*ship->radius) ) {
-			return check_inside_radius_for_big_ships( ship, weapon_obj, pair );
-		}
+	if ( ship_weapon_needs_big_ship_check( ship, weapon_obj ) ) {
+		return check_inside_radius_for_big_ships( ship, weapon_obj, pair );
 	}
 
-	did_hit = ship_weapon_check_collision( ship, weapon_obj );
+	did_hit = ship_weapon_check_collision( ship, weapon_obj, 0.0f, nullptr, pair->hit_test );
 
 	if ( !did_hit )	{
 		// Since we didn't hit, check to see if we can disable all future collisions
@@ -566,6 +703,96 @@ int collide_ship_weapon( obj_pair * pair )
 	return 0;
 }
 
+/**
+ * Does the geometric part of the given ship-weapon collision checks on the worker threads.
+ *
+ * The results are linked to the pairs and are used by collide_ship_weapon() if the objects didn't change in between.
+ * They stay valid until the next call of this function.
+ * @param pairs The pairs to check. a is the ship and b is the weapon.
+ */
+void collide_ship_weapon_evaluate_pairs( SCP_vector<obj_pair> &pairs )
+{
+	TRACE_SCOPE(tracing::CollideShipWeaponEvaluate);
+
+	Ship_weapon_hit_tests.resize(pairs.size());
+
+	for (size_t i = 0; i < pairs.size(); ++i) {
+		pairs[i].hit_test = &Ship_weapon_hit_tests[i];
+	}
+
+	// The weapons hitting the same ship are evaluated together so that their hull checks can be batched
+	auto& order = Ship_weapon_hit_test_order;
+	order.resize(pairs.size());
+	for (size_t i = 0; i < pairs.size(); ++i) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&pairs](size_t left, size_t right) {
+		return OBJ_INDEX(pairs[left].a) < OBJ_INDEX(pairs[right].a);
+	});
+
+	auto& groups = Ship_weapon_hit_test_groups;
+	groups.clear();
+	for (size_t start = 0; start < order.size();) {
+		size_t end = start + 1;
+		while (end < order.size() && end - start < MC_BATCH_MAX && pairs[order[end]].a == pairs[order[start]].a) {
+			++end;
+		}
+
+		groups.push_back(std::make_pair(start, end));
+		start = end;
+	}
+
+	util::worker_pool().parallel_for(groups.size(), 1, [&pairs, &order, &groups](size_t begin, size_t end) {
+		for (size_t group = begin; group < end; ++group) {
+			ship_weapon_hit_test *hull_tests[MC_BATCH_MAX];
+			mc_info *hull_checks[MC_BATCH_MAX];
+			int num_hull_checks = 0;
+
+			for (size_t i = groups[group].first; i < groups[group].second; ++i) {
+				object *ship = pairs[order[i]].a;
+				object *weapon_obj = pairs[order[i]].b;
+				auto test = pairs[order[i]].hit_test;
+
+				float time_limit = 0.0f;
+				if ( ship_weapon_needs_big_ship_check( ship, weapon_obj ) ) {
+					time_limit = big_ship_check_limit_time( ship, weapon_obj );
+				}
+
+				ship_weapon_hit_test_init( test, ship, weapon_obj, time_limit );
+
+				// Arriving ships are not checked at all
+				if ( Ships[ship->instance].is_arriving() ) {
+					continue;
+				}
+
+				if ( ship_weapon_hit_test_check_shield( test ) ) {
+					hull_tests[num_hull_checks] = test;
+					hull_checks[num_hull_checks] = &test->mc_hull;
+					++num_hull_checks;
+				} else {
+					ship_weapon_hit_test_finish( test );
+				}
+			}
+
+			model_collide_batch( hull_checks, num_hull_checks );
+
+			for (int i = 0; i < num_hull_checks; ++i) {
+				hull_tests[i]->hull_collision = hull_checks[i]->num_hits;
+				ship_weapon_hit_test_finish( hull_tests[i] );
+			}
+		}
+	});
+}
+
+/**
+ * Checks if a hit test was used and found that the weapon missed the ship. The collision handling does not change
+ * anything about the ship in that case.
+ */
+bool ship_weapon_hit_test_missed( const ship_weapon_hit_test *hit_test )
+{
+	return hit_test->used && !hit_test->shield_collision && !hit_test->hull_collision;
+}
+
 /**
  * Upper limit estimate ship speed at end of time
  */
@@ -593,15 +820,36 @@ static float estimate_ship_speed_upper_limit( object *ship, float time )
 #define ERROR_STD	2	
 
 /**
- * When inside radius of big ship, check if we can cull collision pair determine the time when pair should next be checked
- * @return 1 if pair can be culled
- * @return 0 if pair can not be culled
+ * Checks if the collision of a laser with a big ship should be predicted with check_inside_radius_for_big_ships()
  */
-static int check_inside_radius_for_big_ships( object *ship, object *weapon_obj, obj_pair *pair )
+static bool ship_weapon_needs_big_ship_check( object *ship, object *weapon_obj )
+{
+	ship_info *sip = &Ship_info[Ships[ship->instance].ship_info_index];
+
+	if ( (sip->is_big_or_huge()) && (weapon_obj->phys_info.flags & PF_CONST_VEL) ) {
+		// Check when within ~1.1 radii.  
+		// This allows good transition between sphere checking (leaving the laser about 200 ms from radius) and checking
+		// within the sphere with little time between.  There may be some time for "small" big ships
+		// Note: culling ships with auto spread shields seems to waste more performance than it saves,
+		// so we're not doing that here
+		if ( !(sip->flags[Ship::Info_Flags::Auto_spread_shields]) && vm_vec_dist_squared(&ship->pos, &weapon_obj->pos) < (1.2f*ship->radius*ship->radius) ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Determines how far into the future a laser inside the radius of a big ship can be checked
+ * @param time_to_max_error If not null this is set to the time until the prediction error gets too large
+ * @return The time limit passed to ship_weapon_check_collision()
+ */
+static float big_ship_check_limit_time( object *ship, object *weapon_obj, float *time_to_max_error )
 {
 	vec3d error_vel;		// vel perpendicular to laser
 	float error_vel_mag;	// magnitude of error_vel
-	float time_to_max_error, time_to_exit_sphere;
+	float time_to_exit_sphere;
 	float ship_speed_at_exit_sphere, error_at_exit_sphere;	
 	float max_error = (float) ERROR_STD / 150.0f * ship->radius;
 	if (max_error < 2)
@@ -616,24 +864,36 @@ static int check_inside_radius_for_big_ships( object *ship, object *weapon_obj,
 	error_vel_mag += 0.5f * (ship->phys_info.max_vel.xyz.z - error_vel_mag)*(time_to_exit_sphere/ship->phys_info.forward_accel_time_const);
 	// error_vel_mag is now average velocity over period
 	error_at_exit_sphere = error_vel_mag * time_to_exit_sphere;
-	time_to_max_error = max_error / error_at_exit_sphere * time_to_exit_sphere;
+	if (time_to_max_error != nullptr) {
+		*time_to_max_error = max_error / error_at_exit_sphere * time_to_exit_sphere;
+	}
 
 	// find the minimum time we can safely check into the future.
 	// limited by (1) time to exit sphere (2) time to weapon expires
 	// if ship_weapon_check_collision comes back with a hit_time > error limit, ok
 	// if ship_weapon_check_collision comes finds no collision, next check time based on error time
-	float limit_time;		// furthest time to check (either lifetime or exit sphere)
 	if ( time_to_exit_sphere < Weapons[weapon_obj->instance].lifeleft ) {
-		limit_time = time_to_exit_sphere;
+		return time_to_exit_sphere;
 	} else {
-		limit_time = Weapons[weapon_obj->instance].lifeleft;
+		return Weapons[weapon_obj->instance].lifeleft;
 	}
+}
+
+/**
+ * When inside radius of big ship, check if we can cull collision pair determine the time when pair should next be checked
+ * @return 1 if pair can be culled
+ * @return 0 if pair can not be culled
+ */
+static int check_inside_radius_for_big_ships( object *ship, object *weapon_obj, obj_pair *pair )
+{
+	float time_to_max_error;
+	float limit_time = big_ship_check_limit_time( ship, weapon_obj, &time_to_max_error );		// furthest time to check (either lifetime or exit sphere)
 
 	// Note:  when estimated hit time is less than 200 ms, look at every frame
 	int hit_time;	// estimated time of hit in ms
 
 	// modify ship_weapon_check_collision to do damage if hit_time is negative (ie, hit occurs in this frame)
-	if ( ship_weapon_check_collision( ship, weapon_obj, limit_time, &hit_time ) ) {
+	if ( ship_weapon_check_collision( ship, weapon_obj, limit_time, &hit_time, pair->hit_test ) ) {
 		// hit occured in while in sphere
 		if (hit_time < 0) {
 			// hit occured in the frame
@@ -13,8 +13,10 @@
 #include "object/objcollide.h"
 #include "object/object.h"
 #include "object/objectdock.h"
+#include "scripting/scripting.h"
 #include "ship/ship.h"
 #include "tracing/tracing.h"
+#include "utils/ThreadPool.h"
 #include "weapon/beam.h"
 #include "weapon/weapon.h"
 #include "tracing/Monitor.h"
@@ -25,26 +27,183 @@
 int Num_pairs = 0;
 int Num_pairs_checked = 0;
 
+// The main collider list. It is kept sorted along the x axis from frame to frame so that the sort done by
+// obj_sort_and_collide() only has to deal with the small changes since the previous frame.
 SCP_vector<int> Collision_sort_list;
 
-class collider_pair
-{
-public:
+// Number of entries at the start of Collision_sort_list which were sorted by the last obj_sort_and_collide()
+// call. Colliders added since then are appended after these.
+static size_t Collision_sort_list_sorted = 0;
+
+// Axis aligned extents of a collider, computed once per obj_sort_and_collide() call
+struct collider_extent {
+	float min[3];
+	float max[3];
+};
+
+static collider_extent Collider_extents[MAX_OBJECTS];
+
+// A pair of overlapping colliders which still has to be collided
+struct collision_candidate {
+	int a;
+	int b;
+	int ship_weapon_pair;	// index into Collision_ship_weapon_pairs or -1
+};
+
+static SCP_vector<collision_candidate> Collision_candidates;
+static SCP_vector<obj_pair> Collision_ship_weapon_pairs;
+static bool Collision_object_changed[MAX_OBJECTS];
+static bool Collision_all_changed;
+
+// The cached collision state of a pair of objects
+struct collider_pair {
 	object *a;
 	object *b;
-	int signature_a;
+	int signature_a;	// 0 if this entry is unused
 	int signature_b;
 	int next_check_time;
-	bool initialized;
 
-	// we need to define a constructor because the hash map can
-	// implicitly insert an object when we use the [] operator
-	collider_pair()
-		: a(nullptr), b(nullptr), signature_a(-1), signature_b(-1), next_check_time(-1), initialized(false)
-	{}
+	// An entry is identified by the signatures of its objects. obj_delete() clears the signature of the object and new
+	// objects get a new signature so the entries of deleted objects never match again.
+	bool is_valid() const
+	{
+		return signature_a == a->signature && signature_b == b->signature;
+	}
+};
+
+/**
+ * Flat open addressing hash table of the collider pairs
+ *
+ * Entries are never removed individually since they invalidate themselves when one of their objects is deleted. The
+ * invalid entries are dropped whenever the table has to grow.
+ */
+class collider_pair_cache
+{
+	SCP_vector<collider_pair> _entries;
+	size_t _num_used = 0;
+
+	static const size_t MIN_CAPACITY = 4096;
+
+	static size_t hash(int signature_a, int signature_b)
+	{
+		uint h = (uint)signature_a * 0x9E3779B1u ^ (uint)signature_b * 0x85EBCA77u;
+		return h ^ (h >> 15);
+	}
+
+	size_t find_slot(int signature_a, int signature_b) const
+	{
+		const size_t mask = _entries.size() - 1;
+
+		for (size_t slot = hash(signature_a, signature_b) & mask;; slot = (slot + 1) & mask) {
+			auto& entry = _entries[slot];
+
+			if (entry.signature_a == 0 || (entry.signature_a == signature_a && entry.signature_b == signature_b)) {
+				return slot;
+			}
+		}
+	}
+
+	void rebuild(size_t min_capacity)
+	{
+		SCP_vector<collider_pair> old_entries;
+		std::swap(old_entries, _entries);
+
+		size_t num_valid = 0;
+		for (auto& entry : old_entries) {
+			if (entry.signature_a > 0 && entry.is_valid()) {
+				++num_valid;
+			}
+		}
+
+		// Keep the table at most half full after rebuilding
+		size_t capacity = MIN_CAPACITY;
+		while (capacity < min_capacity || capacity < num_valid * 2) {
+			capacity *= 2;
+		}
+
+		_entries.assign(capacity, collider_pair());
+		_num_used = 0;
+
+		for (auto& entry : old_entries) {
+			if (entry.signature_a > 0 && entry.is_valid()) {
+				_entries[find_slot(entry.signature_a, entry.signature_b)] = entry;
+				++_num_used;
+			}
+		}
+	}
+
+  public:
+	/**
+	 * @brief Finds the entry of a pair
+	 * @return The entry or nullptr if the pair is not in the cache
+	 */
+	collider_pair* find(object* A, object* B)
+	{
+		if (_entries.empty()) {
+			return nullptr;
+		}
+
+		auto& entry = _entries[find_slot(A->signature, B->signature)];
+		return entry.signature_a == 0 ? nullptr : &entry;
+	}
+
+	/**
+	 * @brief Finds the entry of a pair and adds a new one if there is none
+	 * @param[out] inserted Set to true if a new entry was added
+	 */
+	collider_pair* find_or_insert(object* A, object* B, bool* inserted)
+	{
+		// Grow before the table gets more than 3/4 full so that the probe sequences stay short
+		if ((_num_used + 1) * 4 > _entries.size() * 3) {
+			rebuild(_entries.size());
+		}
+
+		auto& entry = _entries[find_slot(A->signature, B->signature)];
+
+		*inserted = entry.signature_a == 0;
+		if (*inserted) {
+			entry.a = A;
+			entry.b = B;
+			entry.signature_a = A->signature;
+			entry.signature_b = B->signature;
+			entry.next_check_time = timestamp(0);
+			++_num_used;
+		}
+
+		return &entry;
+	}
+
+	/**
+	 * @brief Removes a pair from the cache so that it is treated as a new pair the next time it is found
+	 */
+	void forget(collider_pair* entry)
+	{
+		// Entries can't simply be cleared since that would break the probe sequences of other entries. Negative
+		// signatures never match anything.
+		entry->signature_a = -1;
+	}
+
+	void clear()
+	{
+		_entries.clear();
+		_num_used = 0;
+	}
+
+	/**
+	 * @brief Calls func for every valid entry
+	 */
+	template <typename Func>
+	void for_each(Func func)
+	{
+		for (auto& entry : _entries) {
+			if (entry.signature_a > 0 && entry.is_valid()) {
+				func(entry);
+			}
+		}
+	}
 };
 
-SCP_unordered_map<uint, collider_pair> Collision_cached_pairs;
+static collider_pair_cache Collision_cached_pairs;
 
 class checkobject;
 extern checkobject CheckObjects[MAX_OBJECTS];
@@ -502,29 +661,23 @@ int collide_remove_weapons( )
 	}
 
 	// first pass is to see if any of the weapons don't have collision pairs.
-	for (auto& pair : Collision_cached_pairs) {
-        collider_pair* pair_obj = &pair.second;
+	Collision_cached_pairs.for_each([](collider_pair& pair) {
+		bool can_delete = false;
 
-		if (!pair_obj->initialized) {
-			continue;
+		if (pair.a->type == OBJ_WEAPON) {
+			crw_check_weapon(pair.a->instance, pair.next_check_time);
+			can_delete |= crw_status[pair.a->instance] == CRW_CAN_DELETE;
 		}
 
-		if (pair_obj->a->type == OBJ_WEAPON && pair_obj->signature_a == pair_obj->a->signature) {
-			crw_check_weapon(pair_obj->a->instance, pair_obj->next_check_time);
-
-			if (crw_status[pair_obj->a->instance] == CRW_CAN_DELETE) {
-				pair_obj->initialized = false;
-			}
+		if (pair.b->type == OBJ_WEAPON) {
+			crw_check_weapon(pair.b->instance, pair.next_check_time);
+			can_delete |= crw_status[pair.b->instance] == CRW_CAN_DELETE;
 		}
 
-		if (pair_obj->b->type == OBJ_WEAPON && pair_obj->signature_b == pair_obj->b->signature) {
-			crw_check_weapon(pair_obj->b->instance, pair_obj->next_check_time);
-
-			if (crw_status[pair_obj->b->instance] == CRW_CAN_DELETE) {
-				pair_obj->initialized = false;
-			}
+		if (can_delete) {
+			Collision_cached_pairs.forget(&pair);
 		}
-	}
+	});
 
 	// for each weapon which could be removed, delete the object
 	int num_deleted = 0;
@@ -587,12 +740,13 @@ void obj_remove_collider(int obj_index)
     CheckObjects[obj_index].flags.set(Object::Object_Flags::Not_in_coll);
 #endif	
 
-	for (size_t i = 0; i < Collision_sort_list.size(); ++i ) {
-		if ( Collision_sort_list[i] == obj_index ) {
-			Collision_sort_list[i] = Collision_sort_list.back();
-			Collision_sort_list.pop_back();
-			break;
+	// Erase instead of swapping with the last element so that the list stays sorted for the next frame
+	auto iter = std::find(Collision_sort_list.begin(), Collision_sort_list.end(), obj_index);
+	if (iter != Collision_sort_list.end()) {
+		if ((size_t)(iter - Collision_sort_list.begin()) < Collision_sort_list_sorted) {
+			--Collision_sort_list_sorted;
 		}
+		Collision_sort_list.erase(iter);
 	}
 
 	Objects[obj_index].flags.set(Object::Object_Flags::Not_in_coll);
@@ -601,14 +755,15 @@ void obj_remove_collider(int obj_index)
 void obj_reset_colliders()
 {
 	Collision_sort_list.clear();
+	Collision_sort_list_sorted = 0;
 	Collision_cached_pairs.clear();
 }
 
 void obj_collide_retime_cached_pairs()
 {
-	for ( auto& pair : Collision_cached_pairs ) {
-		pair.second.next_check_time = timestamp(0);
-	}
+	Collision_cached_pairs.for_each([](collider_pair& pair) {
+		pair.next_check_time = timestamp(0);
+	});
 }
 
 //local helper functions only used in objcollide.cpp
@@ -662,58 +817,81 @@ float obj_get_collider_endpoint(int obj_num, int axis, bool min)
     }
 }
 
-void obj_quicksort_colliders(SCP_vector<int> *list, int left, int right, int axis)
+void obj_update_collider_extents(const SCP_vector<int>& list)
 {
-    Assert( axis >= 0 );
-    Assert( axis <= 2 );
+    for (int obj_num : list) {
+        auto& extent = Collider_extents[obj_num];
 
-    if ( right > left ) {
-        int pivot_index = left + (right - left) / 2;
+        for (int axis = 0; axis < 3; ++axis) {
+            extent.min[axis] = obj_get_collider_endpoint(obj_num, axis, true);
+            extent.max[axis] = obj_get_collider_endpoint(obj_num, axis, false);
+        }
+    }
+}
 
-        float pivot_value = obj_get_collider_endpoint((*list)[pivot_index], axis, true);
+// Insertion sort by the minimum endpoint. This is close to linear if the list was already sorted in the last frame
+// since objects only move a small distance each frame.
+void obj_insertion_sort_colliders(SCP_vector<int>& list, size_t begin, size_t end, int axis)
+{
+    for (size_t i = begin + 1; i < end; ++i) {
+        const int obj_num = list[i];
+        const float min = Collider_extents[obj_num].min[axis];
 
-        // swap!
-        int temp = (*list)[pivot_index];
-        (*list)[pivot_index] = (*list)[right];
-        (*list)[right] = temp;
+        size_t j = i;
+        for (; j > begin && Collider_extents[list[j - 1]].min[axis] > min; --j) {
+            list[j] = list[j - 1];
+        }
+        list[j] = obj_num;
+    }
+}
 
-        int store_index = left;
+void obj_sort_colliders(SCP_vector<int>& list, size_t begin, size_t end, int axis)
+{
+    Assert( axis >= 0 );
+    Assert( axis <= 2 );
 
-        for (int i = left; i < right; ++i ) {
-            if ( obj_get_collider_endpoint((*list)[i], axis, true) <= pivot_value ) {
-                temp = (*list)[i];
-                (*list)[i] = (*list)[store_index];
-                (*list)[store_index] = temp;
-                store_index++;
-            }
-        }
+    std::sort(list.begin() + begin, list.begin() + end, [axis](int left, int right) {
+        return Collider_extents[left].min[axis] < Collider_extents[right].min[axis];
+    });
+}
+
+// Sorts the persistent collider list along the x axis. The part of the list which was sorted in the previous frame is
+// nearly sorted so it gets an insertion sort, everything which was added since then is sorted separately and merged in.
+void obj_sort_persistent_colliders(SCP_vector<int>& list, size_t sorted)
+{
+    const auto x_less = [](int left, int right) {
+        return Collider_extents[left].min[0] < Collider_extents[right].min[0];
+    };
+
+    sorted = std::min(sorted, list.size());
 
-        temp = (*list)[right];
-        (*list)[right] = (*list)[store_index];
-        (*list)[store_index] = temp;
+    obj_insertion_sort_colliders(list, 0, sorted, 0);
 
-        obj_quicksort_colliders(list, left, store_index - 1, axis);
-        obj_quicksort_colliders(list, store_index + 1, right, axis);
+    if (sorted < list.size()) {
+        obj_sort_colliders(list, sorted, list.size(), 0);
+        std::inplace_merge(list.begin(), list.begin() + sorted, list.end(), x_less);
     }
 }
 
-void obj_collide_pair(object *A, object *B)
+// Collides two objects. If hit_test is set it is used for ship-weapon collisions if it is still valid.
+// Returns true if the collision check function for the pair was called.
+bool obj_collide_pair(object *A, object *B, ship_weapon_hit_test *hit_test = nullptr)
 {
     TRACE_SCOPE(tracing::CollidePair);
 
     int (*check_collision)( obj_pair *pair ) = nullptr;
     int swapped = 0;
 
-    if ( A==B ) return;		// Don't check collisions with yourself
+    if ( A==B ) return false;		// Don't check collisions with yourself
 
-    if ( !(A->flags[Object::Object_Flags::Collides]) ) return;		// This object doesn't collide with anything
-    if ( !(B->flags[Object::Object_Flags::Collides]) ) return;		// This object doesn't collide with anything
+    if ( !(A->flags[Object::Object_Flags::Collides]) ) return false;		// This object doesn't collide with anything
+    if ( !(B->flags[Object::Object_Flags::Collides]) ) return false;		// This object doesn't collide with anything
 
-    if ((A->flags[Object::Object_Flags::Immobile]) && (B->flags[Object::Object_Flags::Immobile])) return;	// Two immobile objects will never collide with each other
+    if ((A->flags[Object::Object_Flags::Immobile]) && (B->flags[Object::Object_Flags::Immobile])) return false;	// Two immobile objects will never collide with each other
 
     // Make sure you're not checking a parent with it's kid or vicy-versy
     if ( reject_obj_pair_on_parent(A,B) ) {
-        return;
+        return false;
     }
 
     Assert( A->type < 127 );
@@ -762,7 +940,7 @@ void obj_collide_pair(object *A, object *B)
 
         case COLLISION_OF(OBJ_SHIP, OBJ_BEAM):
             if(beam_collide_early_out(B, A)){
-                return;
+                return false;
             }
             swapped = 1;
             check_collision = beam_collide_ship;
@@ -770,14 +948,14 @@ void obj_collide_pair(object *A, object *B)
 
         case COLLISION_OF(OBJ_BEAM, OBJ_SHIP):
             if(beam_collide_early_out(A, B)){
-                return;
+                return false;
             }
             check_collision = beam_collide_ship;
             break;
 
         case COLLISION_OF(OBJ_ASTEROID, OBJ_BEAM):
             if(beam_collide_early_out(B, A)) {
-                return;
+                return false;
             }
             swapped = 1;
             check_collision = beam_collide_asteroid;
@@ -785,26 +963,26 @@ void obj_collide_pair(object *A, object *B)
 
         case COLLISION_OF(OBJ_BEAM, OBJ_ASTEROID):
             if(beam_collide_early_out(A, B)){
-                return;
+                return false;
             }
             check_collision = beam_collide_asteroid;
             break;
         case COLLISION_OF(OBJ_DEBRIS, OBJ_BEAM):
             if(beam_collide_early_out(B, A)) {
-                return;
+                return false;
             }
             swapped = 1;
             check_collision = beam_collide_debris;
             break;
         case COLLISION_OF(OBJ_BEAM, OBJ_DEBRIS):
             if(beam_collide_early_out(A, B)){
-                return;
+                return false;
             }
             check_collision = beam_collide_debris;
             break;
         case COLLISION_OF(OBJ_WEAPON, OBJ_BEAM):
             if(beam_collide_early_out(B, A)) {
-                return;
+                return false;
             }
             swapped = 1;
             check_collision = beam_collide_missile;
@@ -812,7 +990,7 @@ void obj_collide_pair(object *A, object *B)
 
         case COLLISION_OF(OBJ_BEAM, OBJ_WEAPON):
             if(beam_collide_early_out(A, B)){
-                return;
+                return false;
             }
             check_collision = beam_collide_missile;
             break;
@@ -834,49 +1012,26 @@ void obj_collide_pair(object *A, object *B)
         }
 
         default:
-            return;
+            return false;
     }
 
-    if ( !check_collision ) return;
+    if ( !check_collision ) return false;
 
     // Swap them if needed
     if ( swapped ) {
         std::swap(A,B);
     }
 
-    bool valid = false;
-    uint key = (OBJ_INDEX(A) << 12) + OBJ_INDEX(B);
+    bool inserted;
+    collider_pair* collision_info = Collision_cached_pairs.find_or_insert(A, B, &inserted);
 
-    collider_pair* collision_info = &Collision_cached_pairs[key];
-
-    if ( collision_info->initialized ) {
-        // make sure we're referring to the correct objects in case the original pair was deleted
-        if ( collision_info->signature_a == collision_info->a->signature &&
-             collision_info->signature_b == collision_info->b->signature ) {
-            valid = true;
-        } else {
-            collision_info->a = A;
-            collision_info->b = B;
-            collision_info->signature_a = A->signature;
-            collision_info->signature_b = B->signature;
-            collision_info->next_check_time = timestamp(0);
-        }
-    } else {
-        collision_info->a = A;
-        collision_info->b = B;
-        collision_info->signature_a = A->signature;
-        collision_info->signature_b = B->signature;
-        collision_info->initialized = true;
-        collision_info->next_check_time = timestamp(0);
-    }
-
-    if ( valid ) {
+    if ( !inserted ) {
         // if this signature is valid, make the necessary checks to see if we need to collide check
         if ( collision_info->next_check_time == -1 ) {
-            return;
+            return false;
         } else {
             if ( !timestamp_elapsed(collision_info->next_check_time) ) {
-                return;
+                return false;
             }
         }
     } else {
@@ -904,7 +1059,7 @@ void obj_collide_pair(object *A, object *B)
                         // The other object is behind the weapon by more than
                         // its radius, so it will never hit...
                         collision_info->next_check_time = -1;
-                        return;
+                        return false;
                     }
                 }
 
@@ -913,13 +1068,13 @@ void obj_collide_pair(object *A, object *B)
                 vm_vec_sub(&delta_v, &B->phys_info.vel, &A->phys_info.vel);
                 if (vm_vec_dist_squared(&A->pos, &B->pos) > (vm_vec_mag_squared(&delta_v)*Weapons[B->instance].lifeleft*Weapons[B->instance].lifeleft)) {
                     collision_info->next_check_time = -1;
-                    return;
+                    return false;
                 }
 
                 // for nonplayer ships, only create collision pair if close enough
                 if ( (B->parent >= 0) && !((Objects[B->parent].signature == B->parent_sig) && (Objects[B->parent].flags[Object::Object_Flags::Player_ship])) && (vm_vec_dist(&B->pos, &A->pos) < (4.0f*A->radius + 200.0f)) ) {
                     collision_info->next_check_time = -1;
-                    return;
+                    return false;
                 }
             }
         }
@@ -934,7 +1089,7 @@ void obj_collide_pair(object *A, object *B)
                  && (Ship_info[Ships[A->instance].ship_info_index].is_small_ship())
                  && (Weapon_info[Weapons[B->instance].weapon_info_index].subtype == WP_LASER) ) {
                 collision_info->next_check_time = -1;
-                return;
+                return false;
             }
         }
     }
@@ -944,6 +1099,7 @@ void obj_collide_pair(object *A, object *B)
     new_pair.a = A;
     new_pair.b = B;
     new_pair.next_check_time = collision_info->next_check_time;
+    new_pair.hit_test = hit_test;
 
     if ( check_collision(&new_pair) ) {
         // don't have to check ever again
@@ -951,6 +1107,99 @@ void obj_collide_pair(object *A, object *B)
     } else {
         collision_info->next_check_time = new_pair.next_check_time;
     }
+
+    return true;
+}
+
+// Checks if obj_collide_pair() is going to do a ship-weapon collision check for these objects and sets up the pair for
+// it. This runs before any of the pairs are collided so it must not change anything.
+bool obj_find_ship_weapon_pair(object *A, object *B, obj_pair *pair_out)
+{
+    if ( A->type == OBJ_WEAPON && B->type == OBJ_SHIP ) {
+        std::swap(A, B);
+    } else if ( A->type != OBJ_SHIP || B->type != OBJ_WEAPON ) {
+        return false;
+    }
+
+    if ( !(A->flags[Object::Object_Flags::Collides]) || !(B->flags[Object::Object_Flags::Collides]) ) {
+        return false;
+    }
+
+    if ( reject_obj_pair_on_parent(A, B) ) {
+        return false;
+    }
+
+    auto collision_info = Collision_cached_pairs.find(A, B);
+    if ( collision_info != nullptr ) {
+        if ( collision_info->next_check_time == -1 || !timestamp_elapsed(collision_info->next_check_time) ) {
+            return false;
+        }
+    }
+
+    pair_out->a = A;
+    pair_out->b = B;
+    pair_out->next_check_time = -1;
+    pair_out->next = nullptr;
+    pair_out->hit_test = nullptr;
+
+    return true;
+}
+
+// Collides the pairs found by obj_find_overlap_colliders(). The expensive geometry of the ship-weapon checks is done
+// in parallel first, then all pairs are collided in their original order so the results don't depend on the threads.
+void obj_collide_candidates()
+{
+    Collision_ship_weapon_pairs.clear();
+
+    if ( util::worker_pool().concurrency() > 1 ) {
+        for (auto& candidate : Collision_candidates) {
+            obj_pair pair;
+
+            if ( obj_find_ship_weapon_pair(&Objects[candidate.a], &Objects[candidate.b], &pair) ) {
+                candidate.ship_weapon_pair = (int)Collision_ship_weapon_pairs.size();
+                Collision_ship_weapon_pairs.push_back(pair);
+            }
+        }
+
+        collide_ship_weapon_evaluate_pairs(Collision_ship_weapon_pairs);
+    }
+
+    // Colliding may change the ships involved and, through blasts and damage, other ships as well. Precomputed
+    // ship-weapon checks for those are not used anymore. Scripts run by a collision may change any ship.
+    memset(Collision_object_changed, 0, sizeof(Collision_object_changed));
+    Collision_all_changed = false;
+
+    for (auto& candidate : Collision_candidates) {
+        ship_weapon_hit_test* hit_test = nullptr;
+
+        if ( candidate.ship_weapon_pair >= 0 && !Collision_all_changed ) {
+            auto& pair = Collision_ship_weapon_pairs[candidate.ship_weapon_pair];
+
+            if ( !Collision_object_changed[OBJ_INDEX(pair.a)] ) {
+                hit_test = pair.hit_test;
+            }
+        }
+
+        auto script_runs = Script_system.GetRunCount();
+
+        if ( obj_collide_pair(&Objects[candidate.a], &Objects[candidate.b], hit_test) ) {
+            if ( hit_test == nullptr || !ship_weapon_hit_test_missed(hit_test) ) {
+                Collision_object_changed[candidate.a] = true;
+                Collision_object_changed[candidate.b] = true;
+            }
+        }
+
+        if ( Script_system.GetRunCount() != script_runs ) {
+            Collision_all_changed = true;
+        }
+    }
+
+    Collision_candidates.clear();
+}
+
+void obj_collide_mark_changed(object *objp)
+{
+    Collision_object_changed[OBJ_INDEX(objp)] = true;
 }
 
 void obj_find_overlap_colliders(SCP_vector<int> &overlap_list_out, SCP_vector<int> &list, int axis, bool collide)
@@ -963,10 +1212,10 @@ void obj_find_overlap_colliders(SCP_vector<int> &overlap_list_out, SCP_vector<in
     for (int in_index : list){
         bool overlapped = false;
 
-        const float min = obj_get_collider_endpoint(in_index, axis, true);
+        const float min = Collider_extents[in_index].min[axis];
 
         for (size_t j = 0; j < overlappers.size(); ) {
-            const float overlap_max = obj_get_collider_endpoint(overlappers[j], axis, false);
+            const float overlap_max = Collider_extents[overlappers[j]].max[axis];
             if ( min <= overlap_max ) {
                 overlapped = true;
 
@@ -976,7 +1225,7 @@ void obj_find_overlap_colliders(SCP_vector<int> &overlap_list_out, SCP_vector<in
                 }
 
                 if ( collide ) {
-                    obj_collide_pair(&Objects[in_index], &Objects[overlappers[j]]);
+                    Collision_candidates.push_back({ in_index, overlappers[j], -1 });
                 }
             } else {
                 overlappers[j] = overlappers.back();
@@ -997,6 +1246,10 @@ void obj_find_overlap_colliders(SCP_vector<int> &overlap_list_out, SCP_vector<in
 
         overlappers.push_back(in_index);
     }
+
+    if ( collide ) {
+        obj_collide_candidates();
+    }
 }
 } //anon namespace
 
@@ -1018,24 +1271,31 @@ void obj_sort_and_collide(SCP_vector<int>* Collision_list)
 		Collision_list = &Collision_sort_list;
 	}
 
+	obj_update_collider_extents(*Collision_list);
+
 	sort_list_y.clear();
 	{
 		TRACE_SCOPE(tracing::SortColliders);
-		obj_quicksort_colliders(Collision_list, 0, (int)(Collision_list->size() - 1), 0);
+		if (Collision_list == &Collision_sort_list) {
+			obj_sort_persistent_colliders(Collision_sort_list, Collision_sort_list_sorted);
+			Collision_sort_list_sorted = Collision_sort_list.size();
+		} else {
+			obj_sort_colliders(*Collision_list, 0, Collision_list->size(), 0);
+		}
 	}
 	obj_find_overlap_colliders(sort_list_y, *Collision_list, 0, false);
 
 	sort_list_z.clear();
 	{
 		TRACE_SCOPE(tracing::SortColliders);
-		obj_quicksort_colliders(&sort_list_y, 0, (int)(sort_list_y.size() - 1), 1);
+		obj_sort_colliders(sort_list_y, 0, sort_list_y.size(), 1);
 	}
 	obj_find_overlap_colliders(sort_list_z, sort_list_y, 1, false);
 
 	sort_list_y.clear();
 	{
 		TRACE_SCOPE(tracing::SortColliders);
-		obj_quicksort_colliders(&sort_list_z, 0, (int)(sort_list_z.size() - 1), 2);
+		obj_sort_colliders(sort_list_z, 0, sort_list_z.size(), 2);
 	}
 	obj_find_overlap_colliders(sort_list_y, sort_list_z, 2, true);
 }
@@ -17,6 +17,7 @@
 class object;
 struct CFILE;
 struct mc_info;
+struct ship_weapon_hit_test;
 
 // used for ship:ship and ship:debris
 struct collision_info_struct {
@@ -55,6 +56,7 @@ struct obj_pair	{
 	object *b;
 	int	next_check_time;	// a timestamp that when elapsed means to check for a collision
 	struct obj_pair *next;
+	ship_weapon_hit_test *hit_test;	// precomputed ship-weapon collision geometry, may be null
 };
 
 extern SCP_vector<int> Collision_sort_list;
@@ -100,6 +102,18 @@ int collide_weapon_weapon( obj_pair * pair );
 // CODE is locatated in CollideShipWeapon.cpp
 int collide_ship_weapon( obj_pair * pair );
 
+// Does the geometric part of the given ship-weapon collision checks on the worker threads and
+// links the results to the pairs. pair->a is ship and pair->b is weapon.
+// CODE is locatated in CollideShipWeapon.cpp
+void collide_ship_weapon_evaluate_pairs( SCP_vector<obj_pair> &pairs );
+
+// Returns true if collide_ship_weapon() used the hit test and it found no collision
+bool ship_weapon_hit_test_missed( const ship_weapon_hit_test *hit_test );
+
+// Tells the collision pass that the state of the object changed (e.g. it was damaged), so that
+// ship-weapon checks precomputed for it are not used anymore.
+void obj_collide_mark_changed( object *objp );
+
 // Checks debris-weapon collisions.  pair->a is debris and pair->b is weapon.
 // Returns 1 if all future collisions between these can be ignored
 // CODE is locatated in CollideDebrisWeapon.cpp
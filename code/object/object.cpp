@@ -10,6 +10,7 @@
 
 
 
+#include "ai/ai.h"
 #include "asteroid/asteroid.h"
 #include "cmeasure/cmeasure.h"
 #include "debris/debris.h"
@@ -31,6 +32,7 @@
 #include "object/objectdock.h"
 #include "object/objectshield.h"
 #include "object/objectsnd.h"
+#include "object/objectspatial.h"
 #include "observer/observer.h"
 #include "scripting/scripting.h"
 #include "playerman/player.h"
@@ -171,10 +173,8 @@ int free_object_slots(int target_num_used)
 
 	olind = 0;
 
-	// calc num_already_free by walking the obj_free_list
-	num_already_free = 0;
-	for ( objp = GET_FIRST(&obj_free_list); objp != END_OF_LIST(&obj_free_list); objp = GET_NEXT(objp) )
-		num_already_free++;
+	// every slot which is not allocated is on the obj_free_list
+	num_already_free = MAX_OBJECTS - Num_objects;
 
 	if (MAX_OBJECTS - num_already_free < target_num_used)
 		return 0;
@@ -1457,6 +1457,9 @@ void obj_move_all(float frametime)
 
 	obj_merge_created_list();
 
+	obj_spatial_invalidate();
+	ai_frame_prepare();
+
 	// Clear the table that tells which groups of weapons have cast light so far.
 	if(!(Game_mode & GM_MULTIPLAYER) || (MULTIPLAYER_MASTER)) {
 		obj_clear_weapon_group_id_list();
@@ -0,0 +1,201 @@
+/*
+ * Spatial index of the ships in the mission.
+ *
+ * The ships are bucketed by team and sorted along the x axis within each bucket, so a query is a binary search per
+ * team followed by an exact distance check of the ships in the x range.
+ */
+
+#include <algorithm>
+
+#include "iff_defs/iff_defs.h"
+#include "model/model.h"
+#include "object/object.h"
+#include "object/objectspatial.h"
+#include "ship/ship.h"
+#include "tracing/tracing.h"
+
+extern float flFrametime;
+
+namespace {
+
+struct spatial_ship {
+	int objnum;
+	int signature;
+	int team;
+	int list_order;		// position in Ship_obj_list
+
+	vec3d pos;
+	float extent;		// no point of the ship is further away from pos than this
+};
+
+SCP_vector<spatial_ship> Spatial_ships;
+int Spatial_team_start[MAX_IFFS + 1];
+float Spatial_max_extent = 0.0f;
+float Spatial_move_margin = 0.0f;
+bool Spatial_valid = false;
+
+// Scratch space of the queries, which may run on the worker threads
+thread_local SCP_vector<const spatial_ship *> Spatial_found;
+
+float spatial_ship_extent(object *objp)
+{
+	ship_info *sip = &Ship_info[Ships[objp->instance].ship_info_index];
+
+	// big ship searches measure the distance to the bounding box, which can reach outside of the radius
+	float extent = objp->radius;
+	if (sip->is_big_or_huge()) {
+		polymodel *pm = model_get(sip->model_num);
+
+		vec3d corner;
+		for (int i = 0; i < 3; ++i) {
+			corner.a1d[i] = MAX(fl_abs(pm->mins.a1d[i]), fl_abs(pm->maxs.a1d[i]));
+		}
+		extent = MAX(extent, vm_vec_mag(&corner));
+	}
+
+	return extent;
+}
+
+void spatial_build()
+{
+	TRACE_SCOPE(tracing::ObjectSpatialUpdate);
+
+	Spatial_ships.clear();
+	Spatial_max_extent  = 0.0f;
+	Spatial_move_margin = 0.0f;
+
+	int list_order = 0;
+	for (ship_obj *so = GET_FIRST(&Ship_obj_list); so != END_OF_LIST(&Ship_obj_list); so = GET_NEXT(so)) {
+		object *objp = &Objects[so->objnum];
+
+		spatial_ship entry;
+		entry.objnum     = so->objnum;
+		entry.signature  = objp->signature;
+		entry.team       = Ships[objp->instance].team;
+		entry.list_order = list_order++;
+		entry.pos        = objp->pos;
+		entry.extent     = spatial_ship_extent(objp);
+
+		Assertion(entry.team >= 0 && entry.team < MAX_IFFS, "Ship %s has invalid team %d!", Ships[objp->instance].ship_name, entry.team);
+
+		Spatial_max_extent = MAX(Spatial_max_extent, entry.extent);
+
+		// the fastest any ship can get this frame, warping ships are faster than their maximum velocity
+		float speed = MAX(vm_vec_mag(&objp->phys_info.vel), vm_vec_mag(&objp->phys_info.max_vel));
+		speed = MAX(speed, objp->phys_info.afterburner_max_vel.xyz.z);
+		Spatial_move_margin = MAX(Spatial_move_margin, speed);
+
+		Spatial_ships.push_back(entry);
+	}
+
+	// both the searching ship and the found ship may move, and they may accelerate during the frame
+	Spatial_move_margin = 4.0f * Spatial_move_margin * flFrametime + 1.0f;
+
+	std::sort(Spatial_ships.begin(), Spatial_ships.end(), [](const spatial_ship &a, const spatial_ship &b) {
+		if (a.team != b.team) {
+			return a.team < b.team;
+		}
+		return a.pos.xyz.x < b.pos.xyz.x;
+	});
+
+	size_t index = 0;
+	for (int team = 0; team <= MAX_IFFS; ++team) {
+		while (index < Spatial_ships.size() && Spatial_ships[index].team < team) {
+			++index;
+		}
+		Spatial_team_start[team] = (int)index;
+	}
+
+	Spatial_valid = true;
+}
+
+// Ships which were deleted since the index was built are skipped, ships created since then invalidated the index
+bool spatial_ship_current(const spatial_ship &entry)
+{
+	const object *objp = &Objects[entry.objnum];
+
+	return objp->type == OBJ_SHIP && objp->signature == entry.signature;
+}
+
+void spatial_append_in_list_order(SCP_vector<const spatial_ship *> &found, SCP_vector<int> &objnums)
+{
+	std::sort(found.begin(), found.end(),
+	          [](const spatial_ship *a, const spatial_ship *b) { return a->list_order < b->list_order; });
+
+	for (auto entry : found) {
+		objnums.push_back(entry->objnum);
+	}
+}
+
+} // namespace
+
+void obj_spatial_invalidate()
+{
+	Spatial_valid = false;
+}
+
+void obj_spatial_update()
+{
+	if (!Spatial_valid) {
+		spatial_build();
+	}
+}
+
+void obj_spatial_query_ships(const vec3d *pos, float radius, int team_mask, SCP_vector<int> &objnums)
+{
+	obj_spatial_update();
+
+	float padded = radius + Spatial_move_margin;
+	float min_x  = pos->xyz.x - padded - Spatial_max_extent;
+	float max_x  = pos->xyz.x + padded + Spatial_max_extent;
+
+	auto &found = Spatial_found;
+	found.clear();
+
+	for (int team = 0; team < MAX_IFFS; ++team) {
+		if (Spatial_team_start[team] == Spatial_team_start[team + 1] || !iff_matches_mask(team, team_mask)) {
+			continue;
+		}
+
+		auto begin = Spatial_ships.begin() + Spatial_team_start[team];
+		auto end   = Spatial_ships.begin() + Spatial_team_start[team + 1];
+
+		auto it = std::lower_bound(begin, end, min_x,
+		                           [](const spatial_ship &entry, float x) { return entry.pos.xyz.x < x; });
+
+		for (; it != end && it->pos.xyz.x <= max_x; ++it) {
+			float reach = padded + it->extent;
+			if (vm_vec_dist_squared(&it->pos, pos) > reach * reach) {
+				continue;
+			}
+
+			if (spatial_ship_current(*it)) {
+				found.push_back(&*it);
+			}
+		}
+	}
+
+	spatial_append_in_list_order(found, objnums);
+}
+
+void obj_spatial_query_team_ships(int team_mask, SCP_vector<int> &objnums)
+{
+	obj_spatial_update();
+
+	auto &found = Spatial_found;
+	found.clear();
+
+	for (int team = 0; team < MAX_IFFS; ++team) {
+		if (!iff_matches_mask(team, team_mask)) {
+			continue;
+		}
+
+		for (int i = Spatial_team_start[team]; i < Spatial_team_start[team + 1]; ++i) {
+			if (spatial_ship_current(Spatial_ships[i])) {
+				found.push_back(&Spatial_ships[i]);
+			}
+		}
+	}
+
+	spatial_append_in_list_order(found, objnums);
+}
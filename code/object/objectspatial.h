@@ -0,0 +1,29 @@
+/*
+ * Spatial index of the ships in the mission, used by the AI and turret target searches so that they do not have to
+ * look at every ship in the mission for every searching ship or turret.
+ */
+
+
+
+#ifndef _OBJECT_SPATIAL_H
+#define _OBJECT_SPATIAL_H
+
+#include "globalincs/pstypes.h"
+
+// The index is a snapshot of the ship positions and teams. It is invalidated at the start of every frame and whenever
+// a ship is created or changes teams, and rebuilt by the next query. Movement during the frame is accounted for by
+// padding all queries with the largest distance a ship can move in one frame, so queries never miss a ship.
+void obj_spatial_invalidate();
+
+// Rebuilds the index if it is out of date. Queries do this themselves, but queries from worker threads need the index
+// to be built on the main thread first.
+void obj_spatial_update();
+
+// Appends the object numbers of all ships of a team in team_mask which may be within radius of pos. The ships are
+// returned in Ship_obj_list order so that searches pick the same ship as a search over Ship_obj_list would.
+void obj_spatial_query_ships(const vec3d *pos, float radius, int team_mask, SCP_vector<int> &objnums);
+
+// Appends the object numbers of all ships of a team in team_mask, in Ship_obj_list order.
+void obj_spatial_query_team_ships(int team_mask, SCP_vector<int> &objnums);
+
+#endif
@@ -28,6 +28,7 @@
 
 #include "utils/encoding.h"
 #include "utils/unicode.h"
+#include "utils/ThreadPool.h"
 
 #include <utf8.h>
 
@@ -59,6 +60,28 @@ SCP_vector<Bookmark> Bookmarks;	// Stack of all our previously paused parsing
 void allocate_parse_text(size_t size);
 static size_t Parse_text_size = 0;
 
+// The text of a modular table which has been read and processed ahead of its parse callback, see parse_modular_table()
+struct prefetched_table_text {
+	SCP_string filename;
+	int mode = CF_TYPE_ANY;
+
+	// processing the text depends on these
+	bool unicode_text_mode = false;
+	int lcl_pl = 0;
+
+	SCP_vector<char> raw_text;
+	SCP_vector<char> processed_text;
+
+	// the warnings about the encoding, shown when the text is used
+	SCP_vector<SCP_string> warnings;
+};
+
+// The prefetched text of the table whose parse callback is running
+static prefetched_table_text *Prefetched_table_text = nullptr;
+
+// If set, read_raw_file_text() collects its warnings here instead of showing them
+static SCP_vector<SCP_string> *Read_raw_file_text_warnings = nullptr;
+
 
 //	Return true if this character is white space, else false.
 int is_white_space(char ch)
@@ -353,6 +376,20 @@ void advance_to_next_white()
 	}
 }
 
+// Same as !strnicmp(pstr, p, len).  The table parsers try lots of optional tokens that don't
+// match, and almost all of them already differ in the first character, so check that before
+// calling into the library.
+static inline bool parse_token_at(const char *pstr, size_t len, const char *p)
+{
+	if (len == 0)
+		return true;
+
+	if (tolower((unsigned char)*pstr) != tolower((unsigned char)*p))
+		return false;
+
+	return !strnicmp(pstr, p, len);
+}
+
 // Search for specified string, skipping everything up to that point.  Returns 1 if found,
 // 0 if string wasn't found (and hit end of file), or -1 if not found, but end of checking
 // block was reached.
@@ -365,11 +402,11 @@ int skip_to_string(const char *pstr, const char *end)
 	if (end)
 		len2 = strlen(end);
 
-	while ((*Mp != '\0') && strnicmp(pstr, Mp, len) != 0) {
+	while ((*Mp != '\0') && !parse_token_at(pstr, len, Mp)) {
 		if (end && *Mp == '#')
 			return 0;
 
-		if (end && !strnicmp(end, Mp, len2))
+		if (end && parse_token_at(end, len2, Mp))
 			return -1;
 
 		advance_to_eoln(NULL);
@@ -395,11 +432,11 @@ int skip_to_start_of_string(const char *pstr, const char *end)
 	else
 		endlen = 0;
 
-	while ( (*Mp != '\0') && strnicmp(pstr, Mp, len) != 0 ) {
+	while ( (*Mp != '\0') && !parse_token_at(pstr, len, Mp) ) {
 		if (end && *Mp == '#')
 			return 0;
 
-		if (end && !strnicmp(end, Mp, endlen))
+		if (end && parse_token_at(end, endlen, Mp))
 			return 0;
 
 		advance_to_eoln(NULL);
@@ -425,11 +462,11 @@ int skip_to_start_of_string_either(const char *pstr1, const char *pstr2, const c
 	else
 		endlen = 0;
 
-	while ( (*Mp != '\0') && strnicmp(pstr1, Mp, len1) != 0 && strnicmp(pstr2, Mp, len2) != 0 ) {
+	while ( (*Mp != '\0') && !parse_token_at(pstr1, len1, Mp) && !parse_token_at(pstr2, len2, Mp) ) {
 		if (end && *Mp == '#')
 			return 0;
 
-		if (end && !strnicmp(end, Mp, endlen))
+		if (end && parse_token_at(end, endlen, Mp))
 			return 0;
 
 		advance_to_eoln(NULL);
@@ -454,7 +491,7 @@ int required_string(const char *pstr)
 
 	ignore_white_space();
 
-	while (strnicmp(pstr, Mp, strlen(pstr)) != 0 && (count < RS_MAX_TRIES)) {
+	while (!parse_token_at(pstr, strlen(pstr), Mp) && (count < RS_MAX_TRIES)) {
 		error_display(1, "Missing required token: [%s]. Found [%.32s] instead.\n", pstr, next_tokens());
 		advance_to_eoln(NULL);
 		ignore_white_space();
@@ -504,7 +541,7 @@ int check_for_string(const char *pstr)
 {
 	ignore_white_space();
 
-	if (!strnicmp(pstr, Mp, strlen(pstr)))
+	if (parse_token_at(pstr, strlen(pstr), Mp))
 		return 1;
 
 	return 0;
@@ -513,7 +550,7 @@ int check_for_string(const char *pstr)
 // like check for string, but doesn't skip past any whitespace
 int check_for_string_raw(const char *pstr)
 {
-	if (!strnicmp(pstr, Mp, strlen(pstr)))
+	if (parse_token_at(pstr, strlen(pstr), Mp))
 		return 1;
 
 	return 0;
@@ -526,8 +563,9 @@ int optional_string(const char *pstr)
 {
 	ignore_white_space();
 
-	if (!strnicmp(pstr, Mp, strlen(pstr))) {
-		Mp += strlen(pstr);
+	auto len = strlen(pstr);
+	if (parse_token_at(pstr, len, Mp)) {
+		Mp += len;
 		return 1;
 	}
 
@@ -538,10 +576,10 @@ int optional_string_either(const char *str1, const char *str2)
 {
 	ignore_white_space();
 
-	if ( !strnicmp(str1, Mp, strlen(str1)) ) {
+	if ( parse_token_at(str1, strlen(str1), Mp) ) {
 		Mp += strlen(str1);
 		return 0;
-	} else if ( !strnicmp(str2, Mp, strlen(str2)) ) {
+	} else if ( parse_token_at(str2, strlen(str2), Mp) ) {
 		Mp += strlen(str2);
 		return 1;
 	}
@@ -564,7 +602,7 @@ int optional_string_one_of(int arg_count, ...)
 	{
 		pstr = va_arg(vl, char*);
 
-		if ( !strnicmp(pstr, Mp, strlen(pstr)) )
+		if ( parse_token_at(pstr, strlen(pstr), Mp) )
 		{
 			Mp += strlen(pstr);
 			found = idx;
@@ -585,8 +623,8 @@ int required_string_fred(const char *pstr, const char *end)
 		return 0;
 
 	ignore_white_space();
-	while (*Mp != '\0' && strnicmp(pstr, Mp, strlen(pstr)) != 0) {
-		if ((*Mp == '#') || (end && !strnicmp(end, Mp, strlen(end)))) {
+	while (*Mp != '\0' && !parse_token_at(pstr, strlen(pstr), Mp)) {
+		if ((*Mp == '#') || (end && parse_token_at(end, strlen(end), Mp))) {
 			Mp = NULL;
 			break;
 		}
@@ -622,9 +660,9 @@ int optional_string_fred(const char *pstr, const char *end, const char *end2)
 		return 0;
 
 	ignore_white_space();
-	while ((*Mp != '\0') && strnicmp(pstr, Mp, strlen(pstr)) != 0) {
-		if ((*Mp == '#') || (end && !strnicmp(end, Mp, strlen(end))) ||
-			(end2 && !strnicmp(end2, Mp, strlen(end2)))) {
+	while ((*Mp != '\0') && !parse_token_at(pstr, strlen(pstr), Mp)) {
+		if ((*Mp == '#') || (end && parse_token_at(end, strlen(end), Mp)) ||
+			(end2 && parse_token_at(end2, strlen(end2), Mp))) {
 			Mp = NULL;
 			break;
 		}
@@ -661,11 +699,11 @@ int required_string_either(const char *str1, const char *str2)
 	ignore_white_space();
 
 	for (int count = 0; count < RS_MAX_TRIES; ++count) {
-		if (strnicmp(str1, Mp, strlen(str1)) == 0) {
+		if (parse_token_at(str1, strlen(str1), Mp)) {
 			// Mp += strlen(str1);
 			diag_printf("Found required string [%s]\n", token_found = str1);
 			return 0;
-		} else if (strnicmp(str2, Mp, strlen(str2)) == 0) {
+		} else if (parse_token_at(str2, strlen(str2), Mp)) {
 			// Mp += strlen(str2);
 			diag_printf("Found required string [%s]\n", token_found = str2);
 			return 1;
@@ -703,7 +741,7 @@ int required_string_one_of(int arg_count, ...)
 		va_start(vl, arg_count);
 		for (idx = 0; idx < arg_count; idx++) {
 			expected = va_arg(vl, char*);
-			if (strnicmp(expected, Mp, strlen(expected)) == 0) {
+			if (parse_token_at(expected, strlen(expected), Mp)) {
 				diag_printf("Found required string [%s]", token_found = expected);
 				va_end(vl);
 				return idx;
@@ -743,12 +781,12 @@ int required_string_either_fred(const char *str1, const char *str2)
 	ignore_white_space();
 
 	while (*Mp != '\0') {
-		if (!strnicmp(str1, Mp, strlen(str1))) {
+		if (parse_token_at(str1, strlen(str1), Mp)) {
 			// Mp += strlen(str1);
 			diag_printf("Found required string [%s]\n", token_found = str1);
 			return fred_parse_flag = 0;
 
-		} else if (!strnicmp(str2, Mp, strlen(str2))) {
+		} else if (parse_token_at(str2, strlen(str2), Mp)) {
 			// Mp += strlen(str2);
 			diag_printf("Found required string [%s]\n", token_found = str2);
 			return fred_parse_flag = 1;
@@ -1910,7 +1948,8 @@ bool matches_version_specific_tag(const char *line_start, bool &compatible_versi
 
 // Strip comments from a line of input.
 // Goober5000 - rewritten for the second time
-void strip_comments(char *line, bool &in_quote, bool &in_multiline_comment_a, bool &in_multiline_comment_b)
+// Returns a pointer to the terminating null of the stripped line.
+char *strip_comments(char *line, bool &in_quote, bool &in_multiline_comment_a, bool &in_multiline_comment_b)
 {
 	char *writep = line;
 	char *readp = line;
@@ -2000,7 +2039,44 @@ void strip_comments(char *line, bool &in_quote, bool &in_multiline_comment_a, bo
 	{
 		writep[0] = EOLN;
 		writep[1] = '\0';
+		return &writep[1];
 	}
+
+	return readp;
+}
+
+// Moves the prefetched text of the table into Parse_text and Parse_text_raw, if it is the text of this file and it has
+// been processed the way read_file_text() would process it now
+static bool use_prefetched_table_text(const char *filename, int mode)
+{
+	auto table = Prefetched_table_text;
+
+	if ( (table == nullptr) || table->raw_text.empty() || (table->mode != mode) || stricmp(table->filename.c_str(), filename) )
+		return false;
+
+	// an earlier table may have changed the text mode (e.g. $Unicode mode: in game_settings.tbl)
+	if ( (table->unicode_text_mode != Unicode_text_mode) || (table->lcl_pl != Lcl_pl) )
+		return false;
+
+	auto raw_len = strlen(table->raw_text.data());
+	auto processed_len = strlen(table->processed_text.data());
+
+	allocate_parse_text(MAX(raw_len, processed_len) + 1);
+
+	memcpy(Parse_text_raw, table->raw_text.data(), raw_len + 1);
+	memcpy(Parse_text, table->processed_text.data(), processed_len + 1);
+
+	// the callback only reads its file once
+	Prefetched_table_text = nullptr;
+	SCP_vector<char>().swap(table->raw_text);
+	SCP_vector<char>().swap(table->processed_text);
+
+	// the warnings are shown now, when they would have been shown without prefetching.  If the text can't be used
+	// they are dropped instead, since reading the file again shows them.
+	for (auto &warning : table->warnings)
+		Warning(LOCATION, "%s", warning.c_str());
+
+	return true;
 }
 
 int parse_get_line(char *lineout, int max_line_len, const char *start, int max_size, const char *cur)
@@ -2048,6 +2124,10 @@ void read_file_text(const char *filename, int mode, char *processed_text, char *
 		Error(LOCATION, "ERROR: Neither processed_text nor raw_text may be NULL when parsing is paused!!\n");
 	}
 
+	// the text may already be waiting for us if this is a modular table
+	if ( (processed_text == NULL) && (raw_text == NULL) && use_prefetched_table_text(filename, mode) )
+		return;
+
 	// read the raw text
 	read_raw_file_text(filename, mode, raw_text);
 
@@ -2158,6 +2238,21 @@ void allocate_parse_text(size_t size)
 	Parse_text_size = size;
 }
 
+static void read_raw_file_text_warning(const char *format, ...)
+{
+	SCP_string message;
+	va_list args;
+
+	va_start(args, format);
+	vsprintf(message, format, args);
+	va_end(args);
+
+	if (Read_raw_file_text_warnings != nullptr)
+		Read_raw_file_text_warnings->push_back(message);
+	else
+		Warning(LOCATION, "%s", message.c_str());
+}
+
 // Goober5000
 void read_raw_file_text(const char *filename, int mode, char *raw_text)
 {
@@ -2178,6 +2273,7 @@ void read_raw_file_text(const char *filename, int mode, char *raw_text)
 
 	if(!file_len) {
         nprintf(("Error", "Oh noes!!  File is empty! (%s)!\n", filename));
+        cfclose(mf);
         throw parse::ParseException("Failed to open file");
 	}
 
@@ -2228,7 +2324,7 @@ void read_raw_file_text(const char *filename, int mode, char *raw_text)
 			if (isLatin1 && can_reallocate) {
 				// Latin1 is the encoding of retail data and for legacy reasons we convert that to UTF-8.
 				// We still output a warning though...
-				Warning(LOCATION, "Found Latin-1 encoded file %s. This file will be automatically converted to UTF-8 but "
+				read_raw_file_text_warning("Found Latin-1 encoded file %s. This file will be automatically converted to UTF-8 but "
 						"it may cause parsing issues with retail FS2 files since those contained invalid data.\n"
 						"To silence this warning you must convert the files to UTF-8, e.g. by using a program like iconv.",
 						filename);
@@ -2249,14 +2345,14 @@ void read_raw_file_text(const char *filename, int mode, char *raw_text)
 					strncpy(Parse_text_raw, buffer.c_str(), buffer.length());
 				}
 				else {
-					Warning(LOCATION, "File reencoding failed!\n"
+					read_raw_file_text_warning("File reencoding failed!\n"
 						"You will probably encounter encoding issues.");
 
 					// Copy the original data back to the mission text pointer so that we don't loose any data here
 					strcpy(Parse_text_raw, input_str.c_str());
 				}
 			} else {
-				Warning(LOCATION, "Found invalid UTF-8 encoding in file %s at position " PTRDIFF_T_ARG "!\n"
+				read_raw_file_text_warning("Found invalid UTF-8 encoding in file %s at position " PTRDIFF_T_ARG "!\n"
 					"This may cause parsing errors and should be fixed!", filename, invalid - raw_text);
 			}
 		}
@@ -2352,14 +2448,15 @@ void process_raw_file_text(char* processed_text, char* raw_text)
 			outbuf[181 + offset * 2] = '\'';
 		}
 
-		strip_comments(outbuf, in_quote, in_multiline_comment_a, in_multiline_comment_b);
+		char *outbuf_end = strip_comments(outbuf, in_quote, in_multiline_comment_a, in_multiline_comment_b);
 
 		if (Unicode_text_mode) {
 			// In unicode mode we simply assume that the text is already properly encoded in UTF-8
 			// Also, since we don't know how big mp actually is since we get the pointer from the outside we can't use one of
-			// the "safe" strcpy variants here...
-			strcpy(mp, outbuf);
-			mp += strlen(outbuf);
+			// the "safe" copy variants here...
+			auto len = (size_t)(outbuf_end - outbuf);
+			memcpy(mp, outbuf, len + 1);
+			mp += len;
 		} else {
 			mp += maybe_convert_foreign_characters(outbuf, mp, false);
 		}
@@ -4222,6 +4319,62 @@ void parse_int_list(int *ilist, size_t size)
 }
 
 // parse a modular table of type "name_check" and parse it using the specified function callback
+// Reads all the files of a modular table and strips their comments before the parse callbacks run, so that the
+// callbacks find their text ready in read_file_text().  The callbacks fill the global tables and have to run one after
+// the other in the usual order, but the disk reads (through the cfile prefetching) and the comment stripping of all
+// files run on the worker pool.  The files are opened on this thread since cfile may only be used by one thread.
+static void prefetch_table_texts(SCP_vector<prefetched_table_text> &prefetched, const SCP_vector<SCP_string> &filenames, int mode)
+{
+	// nothing to gain without worker threads, and a paused parse still needs Parse_text
+	if ( (filenames.size() < 2) || (util::worker_pool().concurrency() <= 1) || !Bookmarks.empty() )
+		return;
+
+	cf_prefetch_files(filenames, mode);
+
+	prefetched.resize(filenames.size());
+	for (size_t i = 0; i < filenames.size(); i++) {
+		auto &table = prefetched[i];
+
+		Read_raw_file_text_warnings = &table.warnings;
+
+		try {
+			read_raw_file_text(filenames[i].c_str(), mode);
+		} catch (const parse::ParseException&) {
+			// the callback tries again and handles the error like it always does
+			Read_raw_file_text_warnings = nullptr;
+			table.warnings.clear();
+			continue;
+		}
+
+		Read_raw_file_text_warnings = nullptr;
+
+		table.filename = filenames[i];
+		table.mode = mode;
+		table.unicode_text_mode = Unicode_text_mode;
+		table.lcl_pl = Lcl_pl;
+		table.raw_text.assign(Parse_text_raw, Parse_text_raw + strlen(Parse_text_raw) + 1);
+
+		// stripping comments may add a line ending, and converting characters may make the text longer
+		table.processed_text.resize(get_converted_string_length(Parse_text_raw) + 2);
+	}
+
+	cf_prefetch_clear();
+
+	auto process_texts = [&prefetched](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			auto &table = prefetched[i];
+
+			if (!table.raw_text.empty()) {
+				process_raw_file_text(table.processed_text.data(), table.raw_text.data());
+			}
+		}
+	};
+
+	if (!util::worker_pool().try_parallel_for(prefetched.size(), 1, process_texts)) {
+		prefetched.clear();
+	}
+}
+
 int parse_modular_table(const char *name_check, void (*parse_callback)(const char *filename), int path_type, int sort_type)
 {
 	SCP_vector<SCP_string> tbl_file_names;
@@ -4238,12 +4391,24 @@ int parse_modular_table(const char *name_check, void (*parse_callback)(const cha
 
 	const auto ext = strrchr(name_check, '.');
 
-	for (i = 0; i < num_files; i++){
-		if (ext != nullptr) {
-			tbl_file_names[i] += ext;
+	if (ext != nullptr) {
+		for (auto &tbl_file_name : tbl_file_names) {
+			tbl_file_name += ext;
 		}
+	}
+
+	// other kinds of files (e.g. *-sct.lua) are not read through read_file_text()
+	SCP_vector<prefetched_table_text> prefetched;
+	if ( (ext != nullptr) && !stricmp(ext, ".tbm") ) {
+		prefetch_table_texts(prefetched, tbl_file_names, path_type);
+	}
+
+	for (i = 0; i < num_files; i++){
 		mprintf(("TBM  =>  Starting parse of '%s' ...\n", tbl_file_names[i].c_str()));
+
+		Prefetched_table_text = prefetched.empty() ? nullptr : &prefetched[i];
 		(*parse_callback)(tbl_file_names[i].c_str());
+		Prefetched_table_text = nullptr;
 	}
 
 	Parsing_modular_table = false;
@@ -77,6 +77,7 @@
 #include "object/objectdock.h"
 #include "object/objectshield.h"
 #include "object/objectsnd.h"
+#include "object/objectspatial.h"
 #include "object/waypoint.h"
 #include "parse/generic_log.h"
 #include "parse/parselo.h"
@@ -98,6 +99,7 @@
 #include "starfield/starfield.h"
 #include "starfield/supernova.h"
 #include "stats/medals.h"
+#include "utils/NameLookupCache.h"
 #include "utils/Random.h"
 #include "weapon/beam.h"
 #include "weapon/emp.h"
@@ -1659,13 +1661,20 @@ int get_operator_index(const char *token)
 {
 	Assertion(token != nullptr, "get_operator_index(char*) called with a null token; get a coder!\n");
 
-	for (size_t i=0; i < Operators.size(); i++){
-		if (Operators[i].text == token){
-			return (int)i;
+	// operator names are case sensitive
+	static util::NameLookupCache<SCP_hash<SCP_string>, std::equal_to<SCP_string>> lookup_cache;
+
+	auto matches = [&](int i) { return i < (int)Operators.size() && Operators[i].text == token; };
+
+	return lookup_cache.lookup(token, matches, [&]() -> int {
+		for (size_t i=0; i < Operators.size(); i++){
+			if (Operators[i].text == token){
+				return (int)i;
+			}
 		}
-	}
 
-	return NOT_A_SEXP_OPERATOR;
+		return NOT_A_SEXP_OPERATOR;
+	});
 }
 
 /**
@@ -4446,6 +4455,50 @@ wing *eval_wing(int node)
 	return nullptr;
 }
 
+/**
+ * Gets a mission event from a sexp node.  Returns the index into Mission_events, or -1 if there is no such event.
+ */
+static int eval_mission_event(int node)
+{
+	Assert(node >= 0);
+
+	// check cache
+	if (Sexp_nodes[node].cache)
+	{
+		// have we cached something else?
+		if (Sexp_nodes[node].cache->sexp_node_data_type != OPF_EVENT_NAME)
+			return -1;
+
+		return Sexp_nodes[node].cache->numeric_literal;
+	}
+
+	// maybe forward to a special-arg node
+	if (Sexp_nodes[node].flags & SNF_SPECIAL_ARG_IN_NODE)
+	{
+		auto current_argument = Sexp_replacement_arguments.back();
+		int arg_node = current_argument.second;
+
+		if (arg_node >= 0)
+			return eval_mission_event(arg_node);
+	}
+
+	auto name = CTEXT(node);
+	for (int i = 0; i < Num_mission_events; ++i)
+	{
+		if (!stricmp(Mission_events[i].name, name))
+		{
+			// cache the value, unless this node is a variable or argument because the value may change
+			if (!(Sexp_nodes[node].type & SEXP_FLAG_VARIABLE) && !(Sexp_nodes[node].flags & SNF_SPECIAL_ARG_IN_NODE))
+				Sexp_nodes[node].cache = new sexp_cached_data(OPF_EVENT_NAME, i, -1);
+
+			return i;
+		}
+	}
+
+	// no event by this name
+	return -1;
+}
+
 /**
  * Returns a number parsed from the sexp node text.
  * NOTE: sexp_atoi can only be used if CTEXT was used; i.e. atoi(CTEXT(n))
@@ -10592,6 +10645,7 @@ void sexp_ingame_ship_change_iff(ship *shipp, int new_team)
 	Assert(shipp != nullptr);
 
 	shipp->team = new_team;
+	obj_spatial_invalidate();
 }
 
 // Goober5000
@@ -12669,15 +12723,9 @@ void sexp_send_message_list(int n, bool send_message_chain)
 
 	// find the event that will cancel the message chain
 	if (send_message_chain) {
-		auto name = CTEXT(n);
+		event_num = eval_mission_event(n);
 		n = CDR(n);
 
-		for (int i = 0; i < Num_mission_events; ++i) {
-			if (!stricmp(Mission_events[i].name, name)) {
-				event_num = i;
-				break;
-			}
-		}
 		if (event_num < 0) {
 			return;
 		}
@@ -15447,28 +15495,24 @@ int sexp_previous_event_status( int n, int status )
  */
 int sexp_event_status( int n, int want_true )
 {
-	auto name = CTEXT(n);
+	int i = eval_mission_event(n);
+	if (i < 0)
+		return SEXP_FALSE;
 
-	for (int i = 0; i < Num_mission_events; ++i) {
-		// look for the event name, check it's status.  If formula is gone, we know the state won't ever change.
-		if ( !stricmp(Mission_events[i].name, name) ) {
-			int result = Mission_events[i].result;
-			if (Mission_events[i].formula < 0) {
-				if ( (want_true && result) || (!want_true && !result) )
-					return SEXP_KNOWN_TRUE;
-				else
-					return SEXP_KNOWN_FALSE;
+	// check the event's status.  If formula is gone, we know the state won't ever change.
+	int result = Mission_events[i].result;
+	if (Mission_events[i].formula < 0) {
+		if ( (want_true && result) || (!want_true && !result) )
+			return SEXP_KNOWN_TRUE;
+		else
+			return SEXP_KNOWN_FALSE;
 
-			} else {
-				if ( (want_true && result) || (!want_true && !result) )
-					return SEXP_TRUE;
-				else
-					return SEXP_FALSE;
-			}
-		}
+	} else {
+		if ( (want_true && result) || (!want_true && !result) )
+			return SEXP_TRUE;
+		else
+			return SEXP_FALSE;
 	}
-
-	return SEXP_FALSE;
 }
 
 /**
@@ -15483,7 +15527,7 @@ int sexp_event_delay_status( int n, int want_true, bool use_msecs = false)
 	int rval = SEXP_FALSE;
 	bool use_as_directive = false;
 
-	auto name = CTEXT(n);
+	int i = eval_mission_event(n);
 
 	if (use_msecs) {
 		uint64_t tempDelay = eval_num(CDR(n), is_nan, is_nan_forever);
@@ -15508,31 +15552,24 @@ int sexp_event_delay_status( int n, int want_true, bool use_msecs = false)
 		}
 	}
 
-	for (int i = 0; i < Num_mission_events; ++i) {
-		// look for the event name, check it's status.  If formula is gone, we know the state won't ever change.
-		if ( !stricmp(Mission_events[i].name, name) ) {
-			if ( (fix) Mission_events[i].timestamp + delay >= Missiontime ) {
-				rval = SEXP_FALSE;
-				break;
+	// check the event's status.  If formula is gone, we know the state won't ever change.
+	if (i < 0) {
+		rval = SEXP_FALSE;
+	} else if ( (fix) Mission_events[i].timestamp + delay >= Missiontime ) {
+		rval = SEXP_FALSE;
+	} else {
+		int result = Mission_events[i].result;
+		if (Mission_events[i].formula < 0) {
+			if ( (want_true && result) || (!want_true && !result) ) {
+				rval = SEXP_KNOWN_TRUE;
+			} else {
+				rval = SEXP_KNOWN_FALSE;
 			}
-
-			int result = Mission_events[i].result;
-			if (Mission_events[i].formula < 0) {
-				if ( (want_true && result) || (!want_true && !result) ) {
-					rval = SEXP_KNOWN_TRUE;
-					break;
-				} else {
-					rval = SEXP_KNOWN_FALSE;
-					break;
-				}
+		} else {
+			if ( want_true && result ) {  //) || (!want_true && !result) )
+				rval = SEXP_TRUE;
 			} else {
-				if ( want_true && result ) {  //) || (!want_true && !result) )
-					rval = SEXP_TRUE;
-					break;
-				} else {
-					rval = SEXP_FALSE;
-					break;
-				}
+				rval = SEXP_FALSE;
 			}
 		}
 	}
@@ -15554,20 +15591,16 @@ int sexp_event_delay_status( int n, int want_true, bool use_msecs = false)
  */
 int sexp_event_incomplete(int n)
 {
-	auto name = CTEXT(n);
-	
-	for (int i = 0; i < Num_mission_events; ++i) {
-		if ( !stricmp(Mission_events[i].name, name ) ) {
-			// if the formula is still >= 0 (meaning it is still getting eval'ed), then
-			// the event is incomplete
-			if ( Mission_events[i].formula != -1 )
-				return SEXP_TRUE;
-			else
-				return SEXP_KNOWN_FALSE;
-		}
-	}
+	int i = eval_mission_event(n);
+	if (i < 0)
+		return SEXP_FALSE;
 
-	return SEXP_FALSE;
+	// if the formula is still >= 0 (meaning it is still getting eval'ed), then
+	// the event is incomplete
+	if ( Mission_events[i].formula != -1 )
+		return SEXP_TRUE;
+	else
+		return SEXP_KNOWN_FALSE;
 }
 
 /**
@@ -101,6 +101,38 @@ void physics_init( physics_info * pi )
 //    delta_pos = delta position (framevec)
 // You can extend this to 3d by calling it 3 times, once for each x,y,z component.
 
+// Objects of the same class share their damping constants, the three components of a vector are usually damped by the
+// same constant and every object is simulated with the same frametime, so the same few exponentials are evaluated
+// over and over. They are remembered in a small table which is looked up by the bit patterns of the arguments, so the
+// result is exactly what exp() would return.
+struct physics_decay_entry {
+	float damping;		// 0 marks an empty entry since apply_physics never takes the exponential for it
+	float t;
+	float decay;
+};
+
+#define PHYSICS_DECAY_CACHE_SIZE	64
+
+static physics_decay_entry Physics_decay_cache[PHYSICS_DECAY_CACHE_SIZE];
+
+static float physics_damping_decay(float damping, float t)
+{
+	uint damping_bits, t_bits;
+	memcpy(&damping_bits, &damping, sizeof(damping_bits));
+	memcpy(&t_bits, &t, sizeof(t_bits));
+
+	auto entry = &Physics_decay_cache[((damping_bits * 2654435761u) ^ t_bits) % PHYSICS_DECAY_CACHE_SIZE];
+	if (entry->damping == damping && entry->t == t) {
+		return entry->decay;
+	}
+
+	entry->damping = damping;
+	entry->t       = t;
+	entry->decay   = (float)exp(-t / damping);
+
+	return entry->decay;
+}
+
 void apply_physics( float damping, float desired_vel, float initial_vel, float t, float * new_vel, float * delta_pos )
 {
 	if ( damping < 0.0001f )	{
@@ -111,7 +143,7 @@ void apply_physics( float damping, float desired_vel, float initial_vel, float t
 	} else {
 		float dv, e;
 		dv = initial_vel - desired_vel;
-		e = (float)exp( -t/damping );
+		e = physics_damping_decay( damping, t );
 		if ( delta_pos )
 			*delta_pos = (1.0f - e)*dv*damping + desired_vel*t;
 		if ( new_vel )
@@ -24,6 +24,7 @@
 #include "ship/shipfx.h"
 #include "hud/hudets.h"
 #include "object/object.h"
+#include "object/objectspatial.h"
 #include "model/model.h"
 #include "ship/ship.h"
 #include "parse/parselo.h"
@@ -251,9 +252,7 @@ ADE_VIRTVAR(Name, l_Ship, "string", "Ship name. This is the actual name of the s
 	ship *shipp = &Ships[objh->objp->instance];
 
 	if(ADE_SETTING_VAR && s != nullptr) {
-		auto len = sizeof(shipp->ship_name);
-		strncpy(shipp->ship_name, s, len);
-		shipp->ship_name[len - 1] = 0;
+		ship_rename(shipp, s);
 	}
 
 	return ade_set_args(L, "s", shipp->ship_name);
@@ -734,6 +733,7 @@ ADE_VIRTVAR(Team, l_Ship, "team", "Ship's team", "team", "Ship team, or invalid
 
 	if(ADE_SETTING_VAR && nt > -1) {
 		shipp->team = nt;
+		obj_spatial_invalidate();
 	}
 
 	return ade_set_args(L, "o", l_Team.Set(shipp->team));
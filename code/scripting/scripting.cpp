@@ -1005,6 +1005,8 @@ int script_state::RunBytecode(script_function& hd)
 
 	GR_DEBUG_SCOPE("Lua code");
 
+	++RunCount;
+
 	try {
 		hd.function.call(LuaState);
 	} catch (const LuaException&) {
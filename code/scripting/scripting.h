@@ -179,6 +179,8 @@ class script_state
 
 	SCP_vector<script_function> GameInitFunctions;
 
+	size_t RunCount = 0;
+
 	// Stores references to the Lua values for the hook variables. Uses a raw reference since we do not need the more
 	// advanced features of LuaValue
 	// values are a vector to provide a stack of values. This is necessary to ensure consistent behavior if a scripting
@@ -254,6 +256,9 @@ public:
 	template <typename T>
 	int RunBytecode(script_function& hd, char format = '\0', T* data = nullptr);
 	int RunBytecode(script_function& hd);
+	// The number of times Lua code has been run, this tells code which keeps results across a script call whether a
+	// script may have changed them
+	size_t GetRunCount() const { return RunCount; }
 	bool IsOverride(script_hook &hd);
 	int RunCondition(int condition, object* objp = nullptr, int more_data = 0);
 	bool IsConditionOverride(int action, object *objp=NULL);
@@ -361,6 +366,8 @@ int script_state::RunBytecode(script_function& hd, char format, T* data)
 
 	GR_DEBUG_SCOPE("Lua code");
 
+	++RunCount;
+
 	try {
 		auto ret = hd.function.call(LuaState);
 
@@ -65,6 +65,7 @@
 #include "object/objectdock.h"
 #include "object/objectshield.h"
 #include "object/objectsnd.h"
+#include "object/objectspatial.h"
 #include "object/waypoint.h"
 #include "parse/parselo.h"
 #include "scripting/hook_api.h"
@@ -85,6 +86,7 @@
 #include "species_defs/species_defs.h"
 #include "tracing/Monitor.h"
 #include "tracing/tracing.h"
+#include "utils/NameLookupCache.h"
 #include "utils/Random.h"
 #include "weapon/beam.h"
 #include "weapon/corkscrew.h"
@@ -178,6 +180,10 @@ SCP_vector<exited_ship> Ships_exited;
 SCP_vector<ship_registry_entry> Ship_registry;
 SCP_unordered_map<SCP_string, int, SCP_string_lcase_hash, SCP_string_lcase_equal_to> Ship_registry_map;
 
+// where wing_name_lookup(), wing_lookup() and ship_info_lookup() last found a name
+static util::NameLookupCache<> Wing_name_lookup_cache;
+static util::NameLookupCache<> Ship_info_lookup_cache;
+
 const ship_registry_entry *ship_registry_get(const char *name)
 {
 	auto ship_it = Ship_registry_map.find(name);
@@ -187,6 +193,30 @@ const ship_registry_entry *ship_registry_get(const char *name)
 	return nullptr;
 }
 
+/**
+ * Changes the name of a ship which has already been created.  The ship registry entry of the ship moves to the new
+ * name, so the registry keeps mapping each name to the ship which carries it.
+ */
+void ship_rename(ship *shipp, const char *new_name)
+{
+	Assertion(shipp != nullptr && new_name != nullptr, "NULL passed to ship_rename");
+
+	auto ship_it = Ship_registry_map.find(shipp->ship_name);
+
+	auto len = sizeof(shipp->ship_name);
+	strncpy(shipp->ship_name, new_name, len);
+	shipp->ship_name[len - 1] = 0;
+
+	if (ship_it != Ship_registry_map.end() && Ship_registry[ship_it->second].shipp == shipp)
+	{
+		int index = ship_it->second;
+		Ship_registry_map.erase(ship_it);
+
+		strcpy_s(Ship_registry[index].name, shipp->ship_name);
+		Ship_registry_map[shipp->ship_name] = index;
+	}
+}
+
 
 int	Num_engine_wash_types;
 int	Num_ship_subobj_types;
@@ -630,6 +660,8 @@ static void ship_obj_list_init()
 	for ( i = 0; i < MAX_SHIP_OBJS; i++ ) {
 		ship_obj_list_reset_slot(i);
 	}
+
+	obj_spatial_invalidate();
 }
 
 /**
@@ -654,6 +686,8 @@ static int ship_obj_list_add(int objnum)
 	list_append(&Ship_obj_list, &Ship_objs[i]);
 	Ship_objs[i].flags |= SHIP_OBJ_USED;
 
+	obj_spatial_invalidate();
+
 	return i;
 }
 
@@ -5940,6 +5974,8 @@ void ship_level_init()
 	Ship_registry.clear();
 	Ship_registry_map.clear();
 
+	Wing_name_lookup_cache.clear();
+
 
 	// Empty the subsys list
 	ship_clear_subsystems();
@@ -13307,7 +13343,7 @@ void wing_bash_ship_name(char *ship_name, const char *wing_name, int index, bool
  */
 int wing_name_lookup(const char *name, int ignore_count)
 {
-	int i, wing_limit;
+	int wing_limit;
 
 	Assertion(name != nullptr, "NULL name passed to wing_name_lookup");
 
@@ -13316,18 +13352,23 @@ int wing_name_lookup(const char *name, int ignore_count)
 	else
 		wing_limit = Num_wings;
 
-	if (Fred_running || ignore_count ) {  // current_count not used for Fred..
-		for (i=0; i<wing_limit; i++)
-			if (Wings[i].wave_count && !stricmp(Wings[i].name, name))
-				return i;
+	auto matches = [&](int i) -> bool {
+		if (i >= wing_limit || stricmp(Wings[i].name, name) != 0)
+			return false;
 
-	} else {
-		for (i=0; i<wing_limit; i++)
-			if (Wings[i].current_count && !stricmp(Wings[i].name, name))
+		if (Fred_running || ignore_count)  // current_count not used for Fred..
+			return Wings[i].wave_count != 0;
+		else
+			return Wings[i].current_count != 0;
+	};
+
+	return Wing_name_lookup_cache.lookup(name, matches, [&]() -> int {
+		for (int i=0; i<wing_limit; i++)
+			if (matches(i))
 				return i;
-	}
 
-	return -1;
+		return -1;
+	});
 }
 
 bool wing_has_yet_to_arrive(const wing *wingp)
@@ -13343,11 +13384,15 @@ int wing_lookup(const char *name)
 {
 	Assertion(name != nullptr, "NULL name passed to wing_lookup");
 
-	for(int idx=0;idx<Num_wings;idx++)
-		if(stricmp(Wings[idx].name,name)==0)
-		   return idx;
+	auto matches = [&](int idx) { return idx < Num_wings && stricmp(Wings[idx].name, name) == 0; };
 
-	return -1;
+	return Wing_name_lookup_cache.lookup(name, matches, [&]() -> int {
+		for(int idx=0;idx<Num_wings;idx++)
+			if(matches(idx))
+			   return idx;
+
+		return -1;
+	});
 }
 
 int wing_formation_lookup(const char *formation_name)
@@ -13368,11 +13413,15 @@ static int ship_info_lookup_sub(const char *token)
 {
 	Assertion(token != nullptr, "NULL token passed to ship_info_lookup_sub");
 
-	for (auto it = Ship_info.cbegin(); it != Ship_info.cend(); ++it)
-		if (!stricmp(token, it->name))
-			return (int)std::distance(Ship_info.cbegin(), it);
+	auto matches = [&](int idx) { return idx < (int)Ship_info.size() && !stricmp(token, Ship_info[idx].name); };
 
-	return -1;
+	return Ship_info_lookup_cache.lookup(token, matches, [&]() -> int {
+		for (auto it = Ship_info.cbegin(); it != Ship_info.cend(); ++it)
+			if (!stricmp(token, it->name))
+				return (int)std::distance(Ship_info.cbegin(), it);
+
+		return -1;
+	});
 }
 
 /**
@@ -13521,17 +13570,35 @@ int ship_name_lookup(const char *name, int inc_players)
 {
 	Assertion(name != nullptr, "NULL name passed to ship_name_lookup");
 
-	for (int i=0; i<MAX_SHIPS; i++){
-		if (Ships[i].objnum >= 0){
-			if (Objects[Ships[i].objnum].type == OBJ_SHIP || (Objects[Ships[i].objnum].type == OBJ_START && inc_players)){
-				if (!stricmp(name, Ships[i].ship_name)){
-					return i;
+	// FRED renames ships without going through the ship registry
+	if (Fred_running) {
+		for (int i=0; i<MAX_SHIPS; i++){
+			if (Ships[i].objnum >= 0){
+				if (Objects[Ships[i].objnum].type == OBJ_SHIP || (Objects[Ships[i].objnum].type == OBJ_START && inc_players)){
+					if (!stricmp(name, Ships[i].ship_name)){
+						return i;
+					}
 				}
 			}
 		}
+
+		// couldn't find it
+		return -1;
 	}
-	
-	// couldn't find it
+
+	// the registry entry keeps pointing at a destroyed ship until its death roll is complete, just like the ship
+	// keeps its object until then
+	auto entry = ship_registry_get(name);
+	if (entry == nullptr || entry->shipp == nullptr)
+		return -1;
+
+	auto shipp = entry->shipp;
+	if (shipp->objnum >= 0 && !stricmp(name, shipp->ship_name)){
+		if (Objects[shipp->objnum].type == OBJ_SHIP || (Objects[shipp->objnum].type == OBJ_START && inc_players)){
+			return SHIP_INDEX(shipp);
+		}
+	}
+
 	return -1;
 }
 
@@ -19573,6 +19640,7 @@ void ship_render_weapon_models(model_render_params *ship_render_info, model_draw
 					angles angs = vmd_zero_angles;
 					angs.b = shipp->primary_rotate_ang[i];
 					vm_angles_2_matrix(&pmi->submodel[mn].canonical_orient, &angs);
+					submodel_instance_orient_changed(&pmi->submodel[mn]);
 				}
 			}
 		}
@@ -33,6 +33,7 @@
 #include "network/multi_respawn.h"
 #include "network/multimsgs.h"
 #include "network/multiutil.h"
+#include "object/objcollide.h"
 #include "object/object.h"
 #include "object/objectdock.h"
 #include "object/objectshield.h"
@@ -2206,6 +2207,9 @@ static void ship_do_damage(object *ship_objp, object *other_obj, vec3d *hitpos,
 	Assertion(ship_objp->instance >= 0 && ship_objp->type == OBJ_SHIP, "invalid ship target in ship_do_damage");
 	shipp = &Ships[ship_objp->instance];
 
+	// damage can blow off submodels or kill the ship, which changes how weapons collide with it
+	obj_collide_mark_changed(ship_objp);
+
 	// maybe adjust damage done by shockwave for BIG|HUGE
 	maybe_shockwave_damage_adjust(ship_objp, other_obj, &damage);
 
@@ -755,6 +755,8 @@ add_file_folder("Math"
 	math/staticrand.h
 	math/vecmat.cpp
 	math/vecmat.h
+	math/vecmat_batch.cpp
+	math/vecmat_batch.h
 )
 
 # MenuUI files
@@ -851,6 +853,7 @@ add_file_folder("Model"
 	model/modelanimation.h
 	model/modelanimation_segments.cpp
 	model/modelanimation_segments.h
+	model/modelbvh.cpp
 	model/modelcollide.cpp
 	model/modelinterp.cpp
 	model/modeloctant.cpp
@@ -980,6 +983,8 @@ add_file_folder("Object"
 	object/objectsnd.cpp
 	object/objectsnd.h
 	object/objectsort.cpp
+	object/objectspatial.cpp
+	object/objectspatial.h
 	object/parseobjectdock.cpp
 	object/parseobjectdock.h
 	object/waypoint.cpp
@@ -1491,6 +1496,8 @@ add_file_folder("TgaUtils"
 add_file_folder("Tracing"
 	tracing/categories.cpp
 	tracing/categories.h
+	tracing/CategoryTotals.h
+	tracing/CategoryTotals.cpp
 	tracing/FrameProfiler.h
 	tracing/FrameProfiler.cpp
 	tracing/MainFrameTimer.h
@@ -1535,12 +1542,15 @@ add_file_folder("Utils"
 	utils/HeapAllocator.h
 	utils/id.h
 	utils/join_string.h
+	utils/NameLookupCache.h
 	utils/Random.cpp
 	utils/Random.h
 	utils/RandomRange.h
 	utils/string_utils.cpp
 	utils/string_utils.h
 	utils/strings.h
+	utils/ThreadPool.cpp
+	utils/ThreadPool.h
 	utils/tuples.h
 	utils/unicode.cpp
 	utils/unicode.h
@@ -0,0 +1,44 @@
+
+#include "CategoryTotals.h"
+
+namespace tracing {
+
+void CategoryTotals::processEvent(const trace_event* event) {
+	if (event->type != EventType::Complete) {
+		// Only complete events carry a duration
+		return;
+	}
+
+	if (event->pid == GPU_PID) {
+		// GPU time is not comparable to the CPU time we accumulate here
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(_totalsMutex);
+
+	auto& total = _totals[event->category];
+	total.category = event->category;
+	total.total_ns += event->duration;
+	total.max_ns = std::max(total.max_ns, event->duration);
+	++total.count;
+}
+
+void CategoryTotals::reset() {
+	std::lock_guard<std::mutex> guard(_totalsMutex);
+
+	_totals.clear();
+}
+
+SCP_vector<category_total> CategoryTotals::getTotals() {
+	std::lock_guard<std::mutex> guard(_totalsMutex);
+
+	SCP_vector<category_total> out;
+	out.reserve(_totals.size());
+	for (auto& entry : _totals) {
+		out.push_back(entry.second);
+	}
+
+	return out;
+}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+
+#include "tracing.h"
+
+#include <mutex>
+
+/** @file
+ *  @ingroup tracing
+ */
+
+namespace tracing {
+
+/**
+ * @brief Accumulates the CPU time spent in each category
+ *
+ * Unlike the frame profiler this does not keep track of the call hierarchy. It is meant for headless runs which only
+ * need the aggregated time of a few well known categories over a large number of frames.
+ */
+class CategoryTotals {
+	std::mutex _totalsMutex;
+	SCP_unordered_map<const Category*, category_total> _totals;
+
+ public:
+	void processEvent(const trace_event* event);
+
+	void reset();
+
+	SCP_vector<category_total> getTotals();
+};
+
+}
@@ -41,6 +41,7 @@ Category LoadBatchingBuffers("Load batching buffers", true);
 Category SortColliders("Sort Colliders", false);
 Category FindOverlapColliders("Find overlap colliders", false);
 Category CollidePair("Collide Pair", false);
+Category CollideShipWeaponEvaluate("Collide ship weapon evaluate", false);
 
 Category WeaponPostMove("Weapon post move", false);
 Category ShipPostMove("Ship post move", false);
@@ -51,6 +52,9 @@ Category PreMove("Pre Move", false);
 Category Physics("Physics", false);
 Category PostMove("Post Move", false);
 Category CollisionDetection("Collision Detection", false);
+Category AIProcess("AI process", false);
+Category AIPrepare("AI prepare", false);
+Category ObjectSpatialUpdate("Update object spatial index", false);
 
 Category RenderBuffer("Render Buffer", true);
 
@@ -126,6 +130,7 @@ Category ModelCreateVertexBuffers("Create model vertex buffers", false);
 Category ModelCreateOctants("Create model octants", false);
 Category ModelParseAllBSPTrees("Parse all BSP trees", false);
 Category ModelParseBSPTree("Parse BSP tree", false);
+Category ModelCreateBVHTrees("Create model BVH trees", false);
 Category ModelConfigureVertexBuffers("Model configure vertex buffers", false);
 Category ModelCreateTransparencyIndexBuffer("Model create transparency buffer", false);
 Category ModelCreateDetailIndexBuffers("Model create detail index buffers", false);
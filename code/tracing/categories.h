@@ -54,6 +54,7 @@ extern Category LoadBatchingBuffers;
 extern Category SortColliders;
 extern Category FindOverlapColliders;
 extern Category CollidePair;
+extern Category CollideShipWeaponEvaluate;
 
 extern Category WeaponPostMove;
 extern Category ShipPostMove;
@@ -64,6 +65,9 @@ extern Category PreMove;
 extern Category Physics;
 extern Category PostMove;
 extern Category CollisionDetection;
+extern Category AIProcess;
+extern Category AIPrepare;
+extern Category ObjectSpatialUpdate;
 
 extern Category RenderBuffer;
 
@@ -140,6 +144,7 @@ extern Category ModelCreateVertexBuffers;
 extern Category ModelCreateOctants;
 extern Category ModelParseAllBSPTrees;
 extern Category ModelParseBSPTree;
+extern Category ModelCreateBVHTrees;
 extern Category ModelConfigureVertexBuffers;
 extern Category ModelCreateTransparencyIndexBuffer;
 extern Category ModelCreateDetailIndexBuffers;
@@ -7,6 +7,7 @@
 #include "TraceEventWriter.h"
 #include "MainFrameTimer.h"
 #include "FrameProfiler.h"
+#include "CategoryTotals.h"
 
 #include <cinttypes>
 #include <fstream>
@@ -55,6 +56,7 @@ using namespace tracing;
 std::unique_ptr<ThreadedTraceEventWriter> traceEventWriter;
 std::unique_ptr<ThreadedMainFrameTimer> mainFrameTimer;
 std::unique_ptr<FrameProfiler> frameProfiler;
+std::unique_ptr<CategoryTotals> categoryTotals;
 
 SCP_vector<int> query_objects;
 // The GPU timestamp queries use an internal free list to reduce the number of graphics API calls
@@ -127,6 +129,10 @@ void submit_event(trace_event* evt) {
 	if (frameProfiler) {
 		frameProfiler->processEvent(evt);
 	}
+
+	if (categoryTotals) {
+		categoryTotals->processEvent(evt);
+	}
 }
 
 void process_gpu_events() {
@@ -260,6 +266,27 @@ SCP_string get_frame_profile_output() {
 	return frameProfiler->getContent();
 }
 
+void category_totals_enable() {
+	Assertion(initialized, "Tracing must be initialized before category totals can be enabled!");
+
+	if (!categoryTotals) {
+		categoryTotals.reset(new CategoryTotals());
+	}
+	do_trace_events = true;
+}
+
+void category_totals_reset() {
+	Assertion(categoryTotals, "Category totals must be enabled for this function!");
+
+	categoryTotals->reset();
+}
+
+SCP_vector<category_total> category_totals_get() {
+	Assertion(categoryTotals, "Category totals must be enabled for this function!");
+
+	return categoryTotals->getTotals();
+}
+
 void shutdown() {
 	while (!gpu_events.empty()) {
 		process_events();
@@ -275,6 +302,7 @@ void shutdown() {
 
 	mainFrameTimer = nullptr;
 	traceEventWriter = nullptr;
+	categoryTotals = nullptr;
 
 	initialized = false;
 }
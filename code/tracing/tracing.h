@@ -56,6 +56,17 @@ struct trace_event {
 	float value = -1.f;
 };
 
+/**
+ * @brief Accumulated CPU time of a single category
+ */
+struct category_total {
+	const Category* category = nullptr;
+
+	std::uint64_t total_ns = 0;
+	std::uint64_t max_ns = 0;
+	std::uint64_t count = 0;
+};
+
 /**
  * @brief Initializes the tracing subsystem
  */
@@ -74,6 +85,25 @@ void frame_profile_process_frame();
  */
 SCP_string get_frame_profile_output();
 
+/**
+ * @brief Starts accumulating the total CPU time spent in every category
+ *
+ * This is independent of the command line profiling options and is used by headless tools like the benchmark. Must be
+ * called after init().
+ */
+void category_totals_enable();
+
+/**
+ * @brief Discards all totals accumulated so far
+ */
+void category_totals_reset();
+
+/**
+ * @brief Gets the totals accumulated since the last reset
+ * @return One entry for each category which was entered at least once
+ */
+SCP_vector<category_total> category_totals_get();
+
 /**
  * @brief Deinitializes the tracing subsystem
  */
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+#include "utils/ThreadPool.h"
+
+namespace util {
+
+/**
+ * @brief Remembers where a linear name lookup found each name
+ *
+ * Many lookups search an array for a name with stricmp. The arrays are changed in many places (table parsing, ship
+ * creation, renaming, FRED), so keeping a separate index of them in sync would be fragile. This cache only stores
+ * hints instead: a remembered index is used after checking that the element there still matches the name, and the
+ * normal search runs when it doesn't. As long as the names in the array are unique this gives exactly the result of
+ * the normal search.
+ *
+ * Lookups from jobs of the worker pool use the hints but don't add new ones, so that the cache is only written while
+ * no other thread can read it.
+ *
+ * @tparam Hash The hash of the names, which has to agree with the name comparison of the lookup
+ * @tparam KeyEqual The comparison of the names
+ */
+template <typename Hash = SCP_string_lcase_hash, typename KeyEqual = SCP_string_lcase_equal_to>
+class NameLookupCache {
+	SCP_unordered_map<SCP_string, int, Hash, KeyEqual> _hints;
+
+  public:
+	/**
+	 * @brief Looks up a name
+	 *
+	 * @param name The name to look up
+	 * @param matches A function which checks if the element at the given index is still the one called name
+	 * @param search The normal search, which returns the index or a negative value if there is no such element
+	 * @return The index which search would return
+	 */
+	template <typename Matches, typename Search>
+	int lookup(const char* name, Matches matches, Search search)
+	{
+		SCP_string key(name);
+
+		auto it = _hints.find(key);
+		if (it != _hints.end() && matches(it->second)) {
+			return it->second;
+		}
+
+		int index = search();
+		if (index >= 0 && !in_parallel_job()) {
+			_hints[std::move(key)] = index;
+		}
+
+		return index;
+	}
+
+	/**
+	 * @brief Forgets all hints, which keeps the cache from growing when the names change over time
+	 */
+	void clear() { _hints.clear(); }
+};
+
+} // namespace util
@@ -0,0 +1,206 @@
+#include "utils/ThreadPool.h"
+
+namespace util {
+
+namespace {
+thread_local bool in_job = false;
+}
+
+ThreadPool::ThreadPool(size_t num_threads)
+{
+	_threads.reserve(num_threads);
+	for (size_t i = 0; i < num_threads; ++i) {
+		_threads.emplace_back(&ThreadPool::worker_main, this);
+	}
+}
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(_mutex);
+		_shutdown = true;
+	}
+	_work_available.notify_all();
+
+	for (auto& thread : _threads) {
+		thread.join();
+	}
+}
+size_t ThreadPool::concurrency() const
+{
+	return _threads.size() + 1;
+}
+bool ThreadPool::take_chunk(size_t* begin, size_t* end)
+{
+	if (_job == nullptr || _job_next >= _job_count) {
+		return false;
+	}
+
+	*begin = _job_next;
+	*end = std::min(_job_count, _job_next + _job_grain);
+	_job_next = *end;
+
+	return true;
+}
+void ThreadPool::finish_chunk(size_t num_elements, std::exception_ptr error)
+{
+	std::lock_guard<std::mutex> guard(_mutex);
+
+	if (error) {
+		if (!_job_error) {
+			_job_error = error;
+		}
+
+		// Nobody takes the rest of the job anymore
+		num_elements += _job_count - _job_next;
+		_job_next = _job_count;
+	}
+
+	_job_remaining -= num_elements;
+	if (_job_remaining == 0) {
+		_work_done.notify_all();
+	}
+}
+void ThreadPool::worker_main()
+{
+	std::uint64_t last_generation = 0;
+
+	in_job = true;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_work_available.wait(lock, [this, &last_generation]() {
+			return _shutdown || (_job != nullptr && _job_generation != last_generation && _job_next < _job_count);
+		});
+
+		if (_shutdown) {
+			return;
+		}
+
+		last_generation = _job_generation;
+
+		size_t begin, end;
+		while (take_chunk(&begin, &end)) {
+			auto job = _job;
+
+			lock.unlock();
+			std::exception_ptr error;
+			try {
+				(*job)(begin, end);
+			} catch (...) {
+				error = std::current_exception();
+			}
+			finish_chunk(end - begin, error);
+			lock.lock();
+		}
+	}
+}
+void ThreadPool::parallel_for(size_t count, size_t grain, const RangeFunction& func)
+{
+	if (!try_parallel_for(count, grain, func)) {
+		// The pool is busy with a job of another thread (or of this one if this is a nested call)
+		func(0, count);
+	}
+}
+bool ThreadPool::try_parallel_for(size_t count, size_t grain, const RangeFunction& func)
+{
+	if (count == 0) {
+		return true;
+	}
+
+	grain = std::max(grain, (size_t)1);
+
+	if (_threads.empty() || count <= grain) {
+		// Not worth waking up anyone
+		func(0, count);
+		return true;
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_job != nullptr) {
+		return false;
+	}
+
+	run_job(lock, count, grain, func);
+	return true;
+}
+void ThreadPool::run_job(std::unique_lock<std::mutex>& lock, size_t count, size_t grain, const RangeFunction& func)
+{
+	// Split the work so that every thread gets a few chunks to balance out uneven costs
+	grain = std::max(grain, count / (concurrency() * 4));
+
+	_job = &func;
+	_job_count = count;
+	_job_grain = grain;
+	_job_next = 0;
+	_job_remaining = count;
+	++_job_generation;
+
+	_work_available.notify_all();
+
+	// However this returns, the pool has to be ready for the next job afterwards
+	struct job_guard {
+		ThreadPool* pool;
+		~job_guard()
+		{
+			in_job = false;
+			pool->_job = nullptr;
+			pool->_job_error = nullptr;
+		}
+	} guard{this};
+
+	in_job = true;
+
+	size_t begin, end;
+	while (take_chunk(&begin, &end)) {
+		lock.unlock();
+		std::exception_ptr error;
+		try {
+			func(begin, end);
+		} catch (...) {
+			error = std::current_exception();
+		}
+		finish_chunk(end - begin, error);
+		lock.lock();
+	}
+
+	_work_done.wait(lock, [this]() { return _job_remaining == 0; });
+
+	auto error = _job_error;
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+namespace {
+std::unique_ptr<ThreadPool> global_pool;
+}
+
+bool in_parallel_job()
+{
+	return in_job;
+}
+void worker_pool_init(int num_threads)
+{
+	if (num_threads < 0) {
+		auto hardware_threads = (int)std::thread::hardware_concurrency();
+		num_threads = std::max(hardware_threads - 1, 0);
+	}
+
+	mprintf(("Starting worker pool with %d threads\n", num_threads));
+
+	global_pool.reset(new ThreadPool((size_t)num_threads));
+}
+void worker_pool_close()
+{
+	global_pool.reset();
+}
+ThreadPool& worker_pool()
+{
+	if (!global_pool) {
+		global_pool.reset(new ThreadPool(0));
+	}
+
+	return *global_pool;
+}
+
+} // namespace util
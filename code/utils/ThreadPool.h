@@ -0,0 +1,129 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace util {
+
+/**
+ * @brief A fixed size pool of worker threads
+ *
+ * This is meant for data parallel work inside a single frame or loading step. Work is submitted with parallel_for()
+ * which blocks until all of it has been done. The calling thread takes part in the work so a pool without any worker
+ * threads simply runs everything on the calling thread.
+ *
+ * @warning The functions passed to the pool must not touch any engine state which is not safe to access from multiple
+ * threads. Most of the engine is not!
+ */
+class ThreadPool {
+  public:
+	/**
+	 * @brief A range function which processes the elements [begin, end)
+	 */
+	typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+  private:
+	SCP_vector<std::thread> _threads;
+
+	std::mutex _mutex;
+	std::condition_variable _work_available;
+	std::condition_variable _work_done;
+
+	// The job which is currently being processed. Only one job may be active at a time.
+	const RangeFunction* _job = nullptr;
+	size_t _job_count = 0;
+	size_t _job_grain = 1;
+	size_t _job_next = 0;
+	size_t _job_remaining = 0;
+	std::uint64_t _job_generation = 0;
+	std::exception_ptr _job_error;
+
+	bool _shutdown = false;
+
+	void worker_main();
+
+	// Takes the next chunk of the current job. The mutex must be held while calling this.
+	bool take_chunk(size_t* begin, size_t* end);
+
+	// Marks a chunk as done. If it failed with an exception the rest of the job is skipped.
+	void finish_chunk(size_t num_elements, std::exception_ptr error);
+
+	// Starts a job and works on it until it is done. The mutex must be held and no other job may be active.
+	void run_job(std::unique_lock<std::mutex>& lock, size_t count, size_t grain, const RangeFunction& func);
+
+  public:
+	/**
+	 * @brief Creates a pool
+	 * @param num_threads The number of worker threads in addition to the thread calling parallel_for()
+	 */
+	explicit ThreadPool(size_t num_threads);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * @brief The number of threads which can work on a job, including the calling thread
+	 */
+	size_t concurrency() const;
+
+	/**
+	 * @brief Processes the range [0, count) in parallel and waits until all of it has been processed
+	 *
+	 * If the pool is already busy with another job, e.g. one started by another thread, all of the work is done on
+	 * the calling thread instead.
+	 *
+	 * If func throws, the chunks which have not been started yet are skipped and the first exception is rethrown once
+	 * the running chunks are done.
+	 *
+	 * @param count The number of elements
+	 * @param grain The minimum number of elements processed by one call of func
+	 * @param func The function which does the work
+	 */
+	void parallel_for(size_t count, size_t grain, const RangeFunction& func);
+
+	/**
+	 * @brief Like parallel_for() but returns false without doing anything if the pool is already busy
+	 *
+	 * This is for code which may be reached from inside of another job or from other threads, which can then fall back
+	 * to doing the work itself.
+	 *
+	 * @return true if the work has been done
+	 */
+	bool try_parallel_for(size_t count, size_t grain, const RangeFunction& func);
+};
+
+/**
+ * @brief Checks if the calling thread is running a job of a worker pool
+ *
+ * This is true on the worker threads and on a thread which waits for its parallel_for() to finish. Code which keeps
+ * caches in otherwise read-only data can use this to avoid writing them while other threads may read them.
+ */
+bool in_parallel_job();
+
+/**
+ * @brief Initializes the global worker pool
+ *
+ * @param num_threads The number of worker threads. A negative value uses one thread less than the number of
+ * hardware threads, zero disables threading.
+ */
+void worker_pool_init(int num_threads);
+
+/**
+ * @brief Destroys the global worker pool
+ */
+void worker_pool_close();
+
+/**
+ * @brief Gets the global worker pool
+ *
+ * If worker_pool_init() has not been called the pool does not have any worker threads.
+ */
+ThreadPool& worker_pool();
+
+} // namespace util
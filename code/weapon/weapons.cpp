@@ -43,6 +43,7 @@
 #include "render/batching.h"
 #include "ship/ship.h"
 #include "ship/shiphit.h"
+#include "utils/NameLookupCache.h"
 #include "weapon/beam.h"	// for BEAM_TYPE_? definitions
 #include "weapon/corkscrew.h"
 #include "weapon/emp.h"
@@ -84,6 +85,9 @@ static int Weapon_flyby_sound_timer;
 weapon Weapons[MAX_WEAPONS];
 SCP_vector<weapon_info> Weapon_info;
 
+// where weapon_info_lookup() last found a name
+static util::NameLookupCache<> Weapon_info_lookup_cache;
+
 #define		MISSILE_OBJ_USED	(1<<0)			// flag used in missile_obj struct
 #define		MAX_MISSILE_OBJS	MAX_WEAPONS		// max number of missiles tracked in missile list
 missile_obj Missile_objs[MAX_MISSILE_OBJS];	// array used to store missile object indexes
@@ -548,11 +552,15 @@ int weapon_info_lookup(const char *name)
 {
 	Assertion(name != nullptr, "NULL name passed to weapon_info_lookup");
 
-	for (auto it = Weapon_info.cbegin(); it != Weapon_info.cend(); ++it)
-		if (!stricmp(name, it->name))
-			return (int)std::distance(Weapon_info.cbegin(), it);
+	auto matches = [&](int idx) { return idx < weapon_info_size() && !stricmp(name, Weapon_info[idx].name); };
 
-	return -1;
+	return Weapon_info_lookup_cache.lookup(name, matches, [&]() -> int {
+		for (auto it = Weapon_info.cbegin(); it != Weapon_info.cend(); ++it)
+			if (!stricmp(name, it->name))
+				return (int)std::distance(Weapon_info.cbegin(), it);
+
+		return -1;
+	});
 }
 
 /**
@@ -0,0 +1,199 @@
+/*
+ * Headless mission replay benchmark.
+ *
+ * This is compiled together with the regular game sources into the fs2_bench executable. It loads the mission
+ * passed with -start_mission, steps the simulation for a fixed number of frames with a fixed timestep and writes the
+ * time spent in the major simulation subsystems to a JSON file. Rendering always uses the stub renderer and sound is
+ * disabled so the results only depend on the CPU side of the simulation.
+ */
+
+#include "freespace.h"
+
+#include "cmdline/cmdline.h"
+#include "globalincs/crashdump.h"
+#include "globalincs/systemvars.h"
+#include "io/timer.h"
+#include "libs/jansson.h"
+#include "lighting/lighting.h"
+#include "math/staticrand.h"
+#include "mission/missionparse.h"
+#include "object/object.h"
+#include "playerman/player.h"
+#include "tracing/tracing.h"
+#include "utils/Random.h"
+
+#include <cstdio>
+
+extern void game_init();
+extern void game_shutdown();
+extern int Pre_player_entry;
+
+namespace {
+
+// The simulation is always stepped at this rate so that runs are comparable
+const int BENCH_FRAMES_PER_SECOND = 60;
+
+struct bench_subsystem {
+	const char* name;
+	const tracing::Category* category;
+};
+
+// The subsystems which are written to the output file. Everything else the tracing system sees is written to the
+// "other" section so that new categories show up without having to touch this list.
+const bench_subsystem Bench_subsystems[] = {
+	{ "simulation", &tracing::Simulation },
+	{ "obj_move_all", &tracing::MoveObjects },
+	{ "physics", &tracing::Physics },
+	{ "obj_sort_and_collide", &tracing::CollisionDetection },
+	{ "ai_process", &tracing::AIProcess },
+	{ "ai_prepare", &tracing::AIPrepare },
+	{ "weapon_process_post", &tracing::WeaponPostMove },
+	{ "ship_process_post", &tracing::ShipPostMove },
+	{ "particle_move_all", &tracing::ParticlesMoveAll },
+	{ "particle_effects", &tracing::ProcessParticleEffects },
+	{ "mission_events", &tracing::NonrepeatingEvents },
+};
+
+json_t* bench_total_to_json(const tracing::category_total& total, int frames)
+{
+	return json_pack("{sIsIsIsf}",
+		"total_us", (json_int_t)(total.total_ns / 1000),
+		"max_us", (json_int_t)(total.max_ns / 1000),
+		"calls", (json_int_t)total.count,
+		"avg_us_per_frame", (double)total.total_ns / 1000.0 / (double)frames);
+}
+
+bool bench_write_results(const char* filename, int frames, const SCP_vector<std::uint64_t>& frame_times)
+{
+	auto totals = tracing::category_totals_get();
+
+	std::unique_ptr<json_t> root(json_object());
+	json_object_set_new(root.get(), "mission", json_string(Game_current_mission_filename));
+	json_object_set_new(root.get(), "frames", json_integer(frames));
+	json_object_set_new(root.get(), "frametime", json_real(1.0 / BENCH_FRAMES_PER_SECOND));
+	json_object_set_new(root.get(), "seed", json_integer(Cmdline_bench_seed));
+
+	std::uint64_t frame_total = 0;
+	std::uint64_t frame_min   = frame_times.empty() ? 0 : UINT64_MAX;
+	std::uint64_t frame_max   = 0;
+	for (auto time : frame_times) {
+		frame_total += time;
+		frame_min = std::min(frame_min, time);
+		frame_max = std::max(frame_max, time);
+	}
+	json_object_set_new(root.get(), "frame_us", json_pack("{sIsIsf}",
+		"min", (json_int_t)(frame_min / 1000),
+		"max", (json_int_t)(frame_max / 1000),
+		"avg", frame_times.empty() ? 0.0 : (double)frame_total / 1000.0 / (double)frame_times.size()));
+
+	auto subsystems = json_object();
+	auto other = json_object();
+	for (auto& total : totals) {
+		const char* name = nullptr;
+		for (auto& subsystem : Bench_subsystems) {
+			if (subsystem.category == total.category) {
+				name = subsystem.name;
+				break;
+			}
+		}
+
+		if (name != nullptr) {
+			json_object_set_new(subsystems, name, bench_total_to_json(total, frames));
+		} else {
+			json_object_set_new(other, total.category->getName(), bench_total_to_json(total, frames));
+		}
+	}
+	json_object_set_new(root.get(), "subsystems", subsystems);
+	json_object_set_new(root.get(), "other", other);
+
+	if (json_dump_file(root.get(), filename, JSON_INDENT(2) | JSON_SORT_KEYS) != 0) {
+		fprintf(stderr, "fs2_bench: Failed to write results to '%s'!\n", filename);
+		return false;
+	}
+
+	return true;
+}
+
+int bench_main(int argc, char* argv[])
+{
+	if (!parse_cmdline(argc, argv)) {
+		return 1;
+	}
+
+	if (Cmdline_start_mission == nullptr) {
+		fprintf(stderr, "fs2_bench: No mission specified! Use -start_mission <mission file>.\n");
+		return 1;
+	}
+
+	if (Cmdline_bench_frames <= 0) {
+		fprintf(stderr, "fs2_bench: -bench_frames must be positive!\n");
+		return 1;
+	}
+
+	// The benchmark has no audio and no input
+	Cmdline_freespace_no_sound = 1;
+	Cmdline_freespace_no_music = 1;
+	Cmdline_noninteractive     = true;
+
+	game_init();
+
+	tracing::category_totals_enable();
+
+	Game_mode = GM_NORMAL;
+	strcpy_s(Player->callsign, "Bench");
+	strcpy_s(Game_current_mission_filename, Cmdline_start_mission);
+
+	// Seed before loading so that everything random in the mission load is reproducible as well
+	Random::seed(static_cast<unsigned int>(Cmdline_bench_seed));
+	init_semirand();
+
+	if (!game_start_mission()) {
+		fprintf(stderr, "fs2_bench: Failed to load mission '%s'!\n", Game_current_mission_filename);
+		game_shutdown();
+		return 1;
+	}
+
+	// Only measure the simulation, not the mission load
+	tracing::category_totals_reset();
+
+	const fix frametime = F1_0 / BENCH_FRAMES_PER_SECOND;
+
+	SCP_vector<std::uint64_t> frame_times;
+	frame_times.reserve(Cmdline_bench_frames);
+
+	for (int i = 0; i < Cmdline_bench_frames; ++i) {
+		Frametime       = frametime;
+		flFrametime     = f2fl(frametime);
+		flRealframetime = flFrametime;
+
+		timestamp_inc(Frametime);
+		game_update_missiontime();
+
+		if (Missiontime > Entry_delay_time) {
+			Pre_player_entry = 0;
+		}
+
+		// Lights are normally reset by the render loop
+		light_reset();
+
+		auto start = timer_get_nanoseconds();
+		game_simulation_frame();
+		frame_times.push_back(timer_get_nanoseconds() - start);
+	}
+
+	auto success = bench_write_results(Cmdline_bench_output, Cmdline_bench_frames, frame_times);
+
+	game_level_close();
+	game_shutdown();
+
+	return success ? 0 : 1;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	crashdump::installCrashHandler();
+
+	return bench_main(argc, argv);
+}
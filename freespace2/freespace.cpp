@@ -181,6 +181,7 @@
 #include "tracing/Monitor.h"
 #include "tracing/tracing.h"
 #include "utils/Random.h"
+#include "utils/ThreadPool.h"
 #include "weapon/beam.h"
 #include "weapon/emp.h"
 #include "weapon/flak.h"
@@ -1728,12 +1729,18 @@ void game_init()
 // SOUND INIT END
 /////////////////////////////
 
+#ifdef FS2_BENCH
+	// The benchmark never presents a frame so it always uses the stub renderer
+	bool graphics_inited = gr_init(nullptr, GR_STUB, 1024, 768);
+#else
 	std::unique_ptr<SDLGraphicsOperations> sdlGraphicsOperations;
 	if (!Is_standalone) {
 		// Standalone mode doesn't require graphics operations
 		sdlGraphicsOperations.reset(new SDLGraphicsOperations());
 	}
-	if (!gr_init(std::move(sdlGraphicsOperations))) {
+	bool graphics_inited = gr_init(std::move(sdlGraphicsOperations));
+#endif
+	if (!graphics_inited) {
 		os::dialogs::Message(os::dialogs::MESSAGEBOX_ERROR, "Error intializing graphics!");
 		exit(1);
 		return;
@@ -1746,6 +1753,8 @@ void game_init()
 	// This needs to happen after graphics initialization
 	tracing::init();
 
+	util::worker_pool_init(Cmdline_worker_threads);
+
 // Karajorma - Moved here from the sound init code cause otherwise windows complains
 #ifdef FS2_VOICER
 	if(Cmdline_voice_recognition)
@@ -6678,6 +6687,8 @@ void game_shutdown(void)
 	model_free_all();
 	bm_unload_all();			// unload/free bitmaps, has to be called *after* model_free_all()!
 
+	util::worker_pool_close();
+
 	tracing::shutdown();
 
 	if (LoggingEnabled) {
@@ -7570,6 +7581,8 @@ void game_unpause()
 	}
 }
 
+// fs2_bench provides its own entry point in bench.cpp
+#ifndef FS2_BENCH
 #define DONT_CATCH_MAIN_EXCEPTIONS
 int main(int argc, char *argv[])
 {
@@ -7667,3 +7680,4 @@ int main(int argc, char *argv[])
 
 	return result;
 }
+#endif
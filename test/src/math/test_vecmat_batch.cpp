@@ -0,0 +1,163 @@
+
+#include <gtest/gtest.h>
+#include <math/vecmat.h>
+#include <math/vecmat_batch.h>
+
+#include <cfloat>
+#include <random>
+
+namespace {
+
+// The batch routines do the same operations as the scalar ones, but the compiler may contract multiplies and adds
+// into FMAs differently in the two versions. Each contraction changes the result by at most an ulp of the terms
+// involved, so the results have to agree to a few ulps of the magnitude of those terms.
+const float Max_ulps = 4.0f;
+
+void expect_close(float expected, float actual, float magnitude, float ulps = Max_ulps)
+{
+	EXPECT_NEAR(expected, actual, ulps * FLT_EPSILON * magnitude);
+}
+
+void expect_vec_close(const vec3d &expected, const vec3d &actual, float magnitude, float ulps = Max_ulps)
+{
+	for (int i = 0; i < 3; ++i) {
+		expect_close(expected.a1d[i], actual.a1d[i], magnitude, ulps);
+	}
+}
+
+SCP_vector<vec3d> random_vectors(std::mt19937 &gen, size_t count)
+{
+	std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+	SCP_vector<vec3d> vecs(count);
+	for (auto &v : vecs) {
+		v = vm_vec_new(dist(gen), dist(gen), dist(gen));
+	}
+	return vecs;
+}
+
+matrix random_orient(std::mt19937 &gen)
+{
+	std::uniform_real_distribution<float> dist(-PI, PI);
+
+	angles a;
+	a.p = dist(gen);
+	a.b = dist(gen);
+	a.h = dist(gen);
+
+	matrix m;
+	vm_angles_2_matrix(&m, &a);
+	return m;
+}
+
+// Covers every remainder of the four wide loops and a larger batch
+const size_t Batch_counts[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 1001 };
+
+}
+
+TEST(VecmatBatchTest, rotate) {
+	std::mt19937 gen(1);
+
+	for (auto count : Batch_counts) {
+		auto src = random_vectors(gen, count);
+		auto m = random_orient(gen);
+
+		SCP_vector<vec3d> rotated(count), unrotated(count);
+		vm_vec_rotate_batch(rotated.data(), src.data(), count, &m);
+		vm_vec_unrotate_batch(unrotated.data(), src.data(), count, &m);
+
+		for (size_t i = 0; i < count; ++i) {
+			// the rows of an orientation are unit vectors, so no term is larger than the vector
+			auto magnitude = vm_vec_mag(&src[i]);
+
+			vec3d expected;
+			expect_vec_close(*vm_vec_rotate(&expected, &src[i], &m), rotated[i], magnitude);
+			expect_vec_close(*vm_vec_unrotate(&expected, &src[i], &m), unrotated[i], magnitude);
+		}
+	}
+}
+
+TEST(VecmatBatchTest, rotateInPlace) {
+	std::mt19937 gen(2);
+
+	auto src = random_vectors(gen, 11);
+	auto vecs = src;
+	auto m = random_orient(gen);
+
+	vm_vec_rotate_batch(vecs.data(), vecs.data(), vecs.size(), &m);
+	vm_vec_unrotate_batch(vecs.data(), vecs.data(), vecs.size(), &m);
+
+	// rotating there and back rounds twice in either version
+	for (size_t i = 0; i < vecs.size(); ++i) {
+		expect_vec_close(src[i], vecs[i], vm_vec_mag(&src[i]), 4.0f * Max_ulps);
+	}
+}
+
+TEST(VecmatBatchTest, dotAndDistance) {
+	std::mt19937 gen(3);
+
+	for (auto count : Batch_counts) {
+		auto points = random_vectors(gen, count);
+		auto pos = random_vectors(gen, 1)[0];
+
+		SCP_vector<float> dots(count), dists(count), dists_squared(count);
+		vm_vec_dot_batch(dots.data(), points.data(), count, &pos);
+		vm_vec_dist_batch(dists.data(), points.data(), count, &pos);
+		vm_vec_dist_squared_batch(dists_squared.data(), points.data(), count, &pos);
+
+		for (size_t i = 0; i < count; ++i) {
+			auto dist_squared = vm_vec_dist_squared(&points[i], &pos);
+
+			expect_close(vm_vec_dot(&points[i], &pos), dots[i], vm_vec_mag(&points[i]) * vm_vec_mag(&pos));
+			expect_close(vm_vec_dist(&points[i], &pos), dists[i], fl_sqrt(dist_squared));
+			expect_close(dist_squared, dists_squared[i], dist_squared);
+		}
+	}
+
+	// a point at the position itself
+	vec3d points[4] = { vmd_zero_vector, vmd_x_vector, vmd_zero_vector, vmd_y_vector };
+	float dists[4];
+	vm_vec_dist_batch(dists, points, 4, &vmd_zero_vector);
+
+	EXPECT_EQ(0.0f, dists[0]);
+	EXPECT_EQ(1.0f, dists[1]);
+	EXPECT_EQ(0.0f, dists[2]);
+	EXPECT_EQ(1.0f, dists[3]);
+}
+
+TEST(VecmatBatchTest, normalizeSafe) {
+	std::mt19937 gen(4);
+
+	for (auto count : Batch_counts) {
+		auto vecs = random_vectors(gen, count);
+
+		// null vectors in the four wide part and in the remainder
+		if (count > 1) {
+			vecs[1] = vmd_zero_vector;
+		}
+		if (count > 8) {
+			vecs[8] = vmd_zero_vector;
+		}
+
+		auto expected = vecs;
+		SCP_vector<float> expected_mags(count);
+		for (size_t i = 0; i < count; ++i) {
+			expected_mags[i] = vm_vec_normalize_safe(&expected[i]);
+		}
+
+		SCP_vector<float> mags(count);
+		vm_vec_normalize_safe_batch(vecs.data(), count, mags.data());
+
+		for (size_t i = 0; i < count; ++i) {
+			expect_vec_close(expected[i], vecs[i], 1.0f);
+			expect_close(expected_mags[i], mags[i], expected_mags[i]);
+		}
+
+		if (count > 1) {
+			EXPECT_EQ(1.0f, vecs[1].xyz.x);
+			EXPECT_EQ(0.0f, vecs[1].xyz.y);
+			EXPECT_EQ(0.0f, vecs[1].xyz.z);
+			EXPECT_EQ(1.0f, mags[1]);
+		}
+	}
+}
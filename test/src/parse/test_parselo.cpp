@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 #include <parse/parselo.h>
+#include <utils/ThreadPool.h>
 
 #include "util/FSTestFixture.h"
 
@@ -62,6 +63,54 @@ TEST_F(ParseloTest, utf8_with_bom) {
 	ASSERT_STREQ(content.c_str(), "Hello World");
 }
 
+// The worker pool is shared with the other tests, so it is put back the way it was however a test exits
+class ParseloWorkerPoolTest : public ParseloTest {
+ protected:
+	size_t _num_threads = 0;
+
+	void SetUp() override {
+		ParseloTest::SetUp();
+
+		_num_threads = util::worker_pool().concurrency() - 1;
+	}
+	void TearDown() override {
+		util::worker_pool_init((int)_num_threads);
+
+		ParseloTest::TearDown();
+	}
+};
+
+namespace {
+SCP_vector<SCP_string> modular_table_names;
+
+void parse_modular_test_table(const char* filename)
+{
+	read_file_text(filename, CF_TYPE_TABLES);
+	reset_parse();
+
+	required_string("#Entries");
+	while (optional_string("$Name:")) {
+		SCP_string name;
+		stuff_string(name, F_NAME);
+		modular_table_names.push_back(name);
+	}
+	required_string("#End");
+}
+}
+
+TEST_F(ParseloWorkerPoolTest, modular_tables) {
+	const SCP_vector<SCP_string> expected{"Epsilon", "Gamma", "Delta", "Alpha", "Beta"};
+
+	// Once with the texts read by the callbacks and once with the texts prefetched on the worker pool
+	for (auto num_threads : {0, 2}) {
+		util::worker_pool_init(num_threads);
+		modular_table_names.clear();
+
+		ASSERT_EQ(3, parse_modular_table("*-mtt.tbm", parse_modular_test_table));
+		ASSERT_EQ(expected, modular_table_names);
+	}
+}
+
 TEST(ParseloUtilTest, drop_trailing_whitespace_cstr) {
 	char test_str[256];
 
@@ -29,6 +29,7 @@ add_file_folder("Graphics"
 
 add_file_folder("Math"
     math/test_vecmat.cpp
+    math/test_vecmat_batch.cpp
 )
 
 add_file_folder("menuui"
@@ -15,6 +15,8 @@ test::FSTestFixture::FSTestFixture(uint64_t init_flags) : testing::Test(), _init
 	addCommandlineArg("-parse_cmdline_only");
 	addCommandlineArg("-standalone");
 	addCommandlineArg("-portable_mode");
+	// don't leave VP manifest caches in the test data
+	addCommandlineArg("-no_vp_manifest");
 }
 void test::FSTestFixture::SetUp() {
 	auto currentTest = ::testing::UnitTest::GetInstance()->current_test_info();